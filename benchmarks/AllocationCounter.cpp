@@ -0,0 +1,82 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+// Replaces the global allocation functions so that the benchmarks can report the
+// number of heap allocations that each operation makes.
+
+namespace
+{
+	std::atomic<uint64_t> allocationCount = 0;
+
+	void* Allocate(size_t size)
+	{
+		allocationCount.fetch_add(1, std::memory_order_relaxed);
+
+		void* ptr = std::malloc(size != 0 ? size : 1);
+
+		if (!ptr)
+		{
+			throw std::bad_alloc();
+		}
+
+		return ptr;
+	}
+}
+
+uint64_t Benchmark::GetAllocationCount()
+{
+	return allocationCount.load(std::memory_order_relaxed);
+}
+
+void* operator new(size_t size)
+{
+	return Allocate(size);
+}
+
+void* operator new[](size_t size)
+{
+	return Allocate(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+	std::free(ptr);
+}
@@ -0,0 +1,82 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmark.h"
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace
+{
+	std::vector<std::string> filters;
+	bool headerWritten = false;
+}
+
+void Benchmark::Init(int argc, char** argv)
+{
+	// Any command line arguments are treated as substring filters for the benchmark names.
+	for (int i = 1; i < argc; i++)
+	{
+		filters.emplace_back(argv[i]);
+	}
+}
+
+bool Benchmark::IsSelected(std::string_view name)
+{
+	if (filters.empty())
+	{
+		return true;
+	}
+
+	return std::any_of(
+		filters.begin(),
+		filters.end(),
+		[name](const std::string& filter) { return name.find(filter) != std::string_view::npos; });
+}
+
+void Benchmark::Report(
+	std::string_view name,
+	uint64_t iterationsPerSample,
+	const std::vector<double>& nanosecondsPerIteration,
+	double allocationsPerIteration)
+{
+	std::vector<double> sorted(nanosecondsPerIteration);
+	std::sort(sorted.begin(), sorted.end());
+
+	const double median = sorted[sorted.size() / 2];
+	const double minimum = sorted.front();
+
+	if (!headerWritten)
+	{
+		headerWritten = true;
+		std::printf("%-56s %14s %14s %12s %12s\n", "benchmark", "median ns/op", "min ns/op", "iterations", "allocs/op");
+	}
+
+	std::printf(
+		"%-56.*s %14.1f %14.1f %12llu %12.2f\n",
+		static_cast<int>(name.size()),
+		name.data(),
+		median,
+		minimum,
+		static_cast<unsigned long long>(iterationsPerSample),
+		allocationsPerIteration);
+	std::fflush(stdout);
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace Benchmark
+{
+	void Init(int argc, char** argv);
+
+	bool IsSelected(std::string_view name);
+
+	void Report(
+		std::string_view name,
+		uint64_t iterationsPerSample,
+		const std::vector<double>& nanosecondsPerIteration,
+		double allocationsPerIteration);
+
+	// Gets the number of global operator new calls that the process has made.
+	uint64_t GetAllocationCount();
+
+	template <typename T> inline void DoNotOptimize(T const& value)
+	{
+#if defined(__GNUC__) || defined(__clang__)
+		asm volatile("" : : "r,m"(value) : "memory");
+#else
+		static volatile const void* sink;
+		sink = &value;
+#endif
+	}
+
+	// Runs fn repeatedly and reports the median and minimum time per call, and the average
+	// number of heap allocations per call in the measured samples.
+	// The iteration count is calibrated so that each sample takes at least kMinSampleTime.
+	template <typename Fn> void Run(std::string_view name, Fn&& fn)
+	{
+		using Clock = std::chrono::steady_clock;
+
+		constexpr auto kMinSampleTime = std::chrono::milliseconds(20);
+		constexpr size_t kSampleCount = 15;
+
+		if (!IsSelected(name))
+		{
+			return;
+		}
+
+		uint64_t iterations = 1;
+
+		while (true)
+		{
+			const auto start = Clock::now();
+
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				fn();
+			}
+
+			if ((Clock::now() - start) >= kMinSampleTime || iterations >= (uint64_t(1) << 30))
+			{
+				break;
+			}
+
+			iterations *= 2;
+		}
+
+		std::vector<double> samples;
+		samples.reserve(kSampleCount);
+
+		const uint64_t startAllocationCount = GetAllocationCount();
+
+		for (size_t sample = 0; sample < kSampleCount; sample++)
+		{
+			const auto start = Clock::now();
+
+			for (uint64_t i = 0; i < iterations; i++)
+			{
+				fn();
+			}
+
+			const std::chrono::duration<double, std::nano> elapsed = Clock::now() - start;
+
+			samples.push_back(elapsed.count() / static_cast<double>(iterations));
+		}
+
+		const uint64_t allocationCount = GetAllocationCount() - startAllocationCount;
+
+		Report(
+			name,
+			iterations,
+			samples,
+			static_cast<double>(allocationCount) / static_cast<double>(iterations * kSampleCount));
+	}
+}
@@ -19,16 +19,12 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "FloraOccupantFilter.h"
-#include "cISC4Occupant.h"
+#pragma once
 
-FloraOccupantFilter::FloraOccupantFilter()
+namespace Benchmarks
 {
-}
-
-bool FloraOccupantFilter::IsOccupantTypeIncluded(uint32_t type)
-{
-	constexpr uint32_t kFloraOccupantType = 0x74758926;
-
-	return type == kFloraOccupantType;
+	void RunBitsetBenchmarks();
+	void RunPreviewBenchmarks();
+	void RunRasterizerBenchmarks();
+	void RunFilterBenchmarks();
 }
@@ -0,0 +1,250 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmarks.h"
+#include "Benchmark.h"
+#include "BitsetCellRegion.h"
+#include "BitsetKernels.h"
+#include "CellRegionRasterizer.h"
+#include "ChunkedDemolition.h"
+#include "MultiSelectionRegion.h"
+#include <string>
+#include <vector>
+
+namespace
+{
+	void RunKernelBenchmarks(const char* kernelName, const BitsetKernels::KernelTable& kernels, size_t wordCount)
+	{
+		const std::string suffix = std::string("/") + kernelName + '/' + std::to_string(wordCount) + "words";
+
+		std::vector<uint64_t> destination(wordCount, 0x0F0F0F0F0F0F0F0Full);
+		std::vector<uint64_t> source(wordCount, 0x00FF00FF00FF00FFull);
+
+		Benchmark::Run("bitset_kernel/fill" + suffix, [&]()
+		{
+			kernels.fill(destination.data(), wordCount, 0);
+			Benchmark::DoNotOptimize(destination);
+		});
+
+		Benchmark::Run("bitset_kernel/copy" + suffix, [&]()
+		{
+			kernels.copy(destination.data(), source.data(), wordCount);
+			Benchmark::DoNotOptimize(destination);
+		});
+
+		Benchmark::Run("bitset_kernel/unite" + suffix, [&]()
+		{
+			kernels.unite(destination.data(), source.data(), wordCount);
+			Benchmark::DoNotOptimize(destination);
+		});
+
+		Benchmark::Run("bitset_kernel/intersect" + suffix, [&]()
+		{
+			kernels.intersect(destination.data(), source.data(), wordCount);
+			Benchmark::DoNotOptimize(destination);
+		});
+
+		Benchmark::Run("bitset_kernel/subtract" + suffix, [&]()
+		{
+			kernels.subtract(destination.data(), source.data(), wordCount);
+			Benchmark::DoNotOptimize(destination);
+		});
+
+		Benchmark::Run("bitset_kernel/popcount" + suffix, [&]()
+		{
+			uint64_t count = kernels.popCount(source.data(), wordCount);
+			Benchmark::DoNotOptimize(count);
+		});
+	}
+
+	void FillDiagonal(BitsetCellRegion& region, int32_t thickness)
+	{
+		const auto& bounds = region.GetBounds();
+
+		std::vector<CellRegionRasterizer::RowSpan> spans;
+		CellRegionRasterizer::GetDiagonalSpans(
+			bounds.topLeftX,
+			bounds.topLeftY,
+			bounds.bottomRightX,
+			bounds.bottomRightY,
+			thickness,
+			bounds.topLeftX,
+			bounds.topLeftY,
+			spans);
+
+		for (uint32_t z = 0; z < spans.size(); z++)
+		{
+			region.FillRowSpan(z, spans[z].start, spans[z].end, true);
+		}
+	}
+
+	void RunRegionBenchmarks(int32_t size)
+	{
+		const std::string suffix = '/' + std::to_string(size) + 'x' + std::to_string(size);
+		const int32_t max = size - 1;
+
+		// The byte per cell region the game uses, for comparison with the bitset operations.
+		SC4CellRegion<int32_t> cellRegion(0, 0, max, max, false);
+		SC4CellRegion<int32_t> otherCellRegion = CellRegionRasterizer::CreateDiagonalRegion(0, 0, max, max, 9, 0, 0);
+
+		Benchmark::Run("cell_region/unite" + suffix, [&]()
+		{
+			for (uint32_t z = 0; z < static_cast<uint32_t>(size); z++)
+			{
+				for (uint32_t x = 0; x < static_cast<uint32_t>(size); x++)
+				{
+					if (otherCellRegion.cellMap.GetValue(x, z))
+					{
+						cellRegion.cellMap.SetValue(x, z, true);
+					}
+				}
+			}
+			Benchmark::DoNotOptimize(cellRegion);
+		});
+
+		BitsetCellRegion region(0, 0, max, max);
+		BitsetCellRegion diagonal(0, 0, max, max);
+		FillDiagonal(diagonal, 9);
+
+		Benchmark::Run("bitset_region/unite" + suffix, [&]()
+		{
+			region.Unite(diagonal);
+			Benchmark::DoNotOptimize(region);
+		});
+
+		Benchmark::Run("bitset_region/subtract" + suffix, [&]()
+		{
+			region.Subtract(diagonal);
+			Benchmark::DoNotOptimize(region);
+		});
+
+		// A region that is offset by a partial word, the rows must be shifted into place.
+		BitsetCellRegion offsetDiagonal(13, 7, max + 13, max + 7);
+		FillDiagonal(offsetDiagonal, 9);
+
+		Benchmark::Run("bitset_region/unite_unaligned" + suffix, [&]()
+		{
+			region.Unite(offsetDiagonal);
+			Benchmark::DoNotOptimize(region);
+		});
+
+		Benchmark::Run("bitset_region/popcount" + suffix, [&]()
+		{
+			uint64_t count = diagonal.PopCount();
+			Benchmark::DoNotOptimize(count);
+		});
+
+		Benchmark::Run("bitset_region/from_cell_region" + suffix, [&]()
+		{
+			region.CopyFrom(otherCellRegion);
+			Benchmark::DoNotOptimize(region);
+		});
+
+		Benchmark::Run("bitset_region/to_cell_region" + suffix, [&]()
+		{
+			diagonal.CopyTo(cellRegion);
+			Benchmark::DoNotOptimize(cellRegion);
+		});
+
+		// The preview regions alternate between the bounds of successive selections.
+		BitsetCellRegion halfDiagonal(0, 0, max, max / 2);
+		FillDiagonal(halfDiagonal, 9);
+		ReusableCellRegion reusableCellRegion;
+		bool useHalfDiagonal = false;
+
+		Benchmark::Run("bitset_region/to_reusable_cell_region" + suffix, [&]()
+		{
+			const BitsetCellRegion& source = useHalfDiagonal ? halfDiagonal : diagonal;
+			useHalfDiagonal = !useHalfDiagonal;
+
+			Benchmark::DoNotOptimize(source.CopyTo(reusableCellRegion));
+		});
+	}
+
+	void RunMultiSelectionBenchmarks()
+	{
+		// Four overlapping 64x64 drags combined with the current drag, as the preview
+		// does for each selection update.
+		MultiSelectionRegion multiSelection;
+
+		for (int32_t i = 0; i < 4; i++)
+		{
+			multiSelection.Add(SC4CellRegion<int32_t>(i * 48, i * 16, i * 48 + 63, i * 16 + 63, true));
+		}
+
+		multiSelection.Subtract(SC4CellRegion<int32_t>(40, 40, 80, 60, true));
+
+		const SC4CellRegion<int32_t> currentRegion(100, 100, 163, 163, true);
+
+		Benchmark::Run("multi_selection/combine/4x64x64", [&]()
+		{
+			const SC4CellRegion<int32_t>& region = multiSelection.Combine(currentRegion);
+			Benchmark::DoNotOptimize(region);
+		});
+	}
+
+	void RunChunkedDemolitionBenchmarks()
+	{
+		// Splitting a full large city tile into the chunks that are demolished in each frame,
+		// including the conversion of each chunk to the game's region type.
+		const SC4CellRegion<int32_t> region(0, 0, 255, 255, true);
+		ChunkedDemolition chunkedDemolition;
+
+		Benchmark::Run("chunked_demolition/split/256x256", [&]()
+		{
+			chunkedDemolition.Start(region, 4096);
+
+			const BitsetCellRegion* pChunk = chunkedDemolition.GetNextChunk();
+
+			while (pChunk)
+			{
+				SC4CellRegion<int32_t> chunkRegion = pChunk->ToCellRegion();
+				Benchmark::DoNotOptimize(chunkRegion);
+
+				chunkedDemolition.CompleteChunk(true, 0);
+				pChunk = chunkedDemolition.GetNextChunk();
+			}
+
+			Benchmark::DoNotOptimize(chunkedDemolition);
+		});
+	}
+}
+
+void Benchmarks::RunBitsetBenchmarks()
+{
+	// 256 words is a 256x64 cell region, 4096 words is 256x256.
+	for (size_t wordCount : { size_t(256), size_t(4096) })
+	{
+		RunKernelBenchmarks("scalar", BitsetKernels::GetScalarKernels(), wordCount);
+
+		const BitsetKernels::KernelTable* avx2Kernels = BitsetKernels::GetAvx2Kernels();
+
+		if (avx2Kernels)
+		{
+			RunKernelBenchmarks("avx2", *avx2Kernels, wordCount);
+		}
+	}
+
+	RunRegionBenchmarks(64);
+	RunRegionBenchmarks(256);
+	RunMultiSelectionBenchmarks();
+	RunChunkedDemolitionBenchmarks();
+}
@@ -0,0 +1,193 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FakeCity.h"
+#include "NetworkTypeFlags.h"
+#include <random>
+
+FakeCity::FakeOccupant::FakeOccupant(uint32_t type, uint32_t networkFlags, int32_t cellX, int32_t cellZ)
+	: type(type), networkFlags(networkFlags), cellX(cellX), cellZ(cellZ), refCount(0)
+{
+}
+
+bool FakeCity::FakeOccupant::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4NetworkOccupant && type == kNetworkOccupantType)
+	{
+		*ppvObj = static_cast<cISC4NetworkOccupant*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t FakeCity::FakeOccupant::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t FakeCity::FakeOccupant::Release()
+{
+	// The occupant lifetime is owned by the City.
+	return refCount > 0 ? --refCount : 0;
+}
+
+uint32_t FakeCity::FakeOccupant::GetType() const
+{
+	return type;
+}
+
+bool FakeCity::FakeOccupant::HasAnyNetworkFlag(uint32_t flags) const
+{
+	return (networkFlags & flags) != 0;
+}
+
+int32_t FakeCity::FakeOccupant::GetCellX() const
+{
+	return cellX;
+}
+
+int32_t FakeCity::FakeOccupant::GetCellZ() const
+{
+	return cellZ;
+}
+
+FakeCity::FakeLot::FakeLot(cISC4ZoneManager::ZoneType zoneType)
+	: zoneType(zoneType)
+{
+}
+
+bool FakeCity::FakeLot::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	return false;
+}
+
+uint32_t FakeCity::FakeLot::AddRef()
+{
+	return 1;
+}
+
+uint32_t FakeCity::FakeLot::Release()
+{
+	return 1;
+}
+
+cISC4ZoneManager::ZoneType FakeCity::FakeLot::GetZoneType() const
+{
+	return zoneType;
+}
+
+bool FakeCity::FakeLotManager::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	return false;
+}
+
+uint32_t FakeCity::FakeLotManager::AddRef()
+{
+	return 1;
+}
+
+uint32_t FakeCity::FakeLotManager::Release()
+{
+	return 1;
+}
+
+cISC4Lot* FakeCity::FakeLotManager::GetOccupantLot(cISC4Occupant* pOccupant)
+{
+	auto it = occupantLots.find(pOccupant);
+
+	return it != occupantLots.end() ? it->second : nullptr;
+}
+
+void FakeCity::FakeLotManager::SetOccupantLot(cISC4Occupant* pOccupant, cISC4Lot* pLot)
+{
+	occupantLots[pOccupant] = pLot;
+}
+
+std::unique_ptr<FakeCity::City> FakeCity::Create(
+	int32_t size,
+	uint32_t occupantsPerCell,
+	uint32_t floraPercent,
+	uint32_t networkPercent)
+{
+	using ZoneType = cISC4ZoneManager::ZoneType;
+
+	static constexpr NetworkTypeFlags kNetworkTypes[] =
+	{
+		NetworkTypeFlags::Road,
+		NetworkTypeFlags::Street,
+		NetworkTypeFlags::Rail,
+		NetworkTypeFlags::Highway,
+		NetworkTypeFlags::WaterPipe,
+		NetworkTypeFlags::PowerPole,
+	};
+
+	// A fixed seed keeps the workload identical between runs.
+	std::mt19937 random(0xB011D02E);
+	std::uniform_int_distribution<uint32_t> percentDistribution(0, 99);
+	std::uniform_int_distribution<size_t> networkDistribution(0, std::size(kNetworkTypes) - 1);
+	std::uniform_int_distribution<uint32_t> zoneDistribution(
+		static_cast<uint32_t>(ZoneType::None),
+		static_cast<uint32_t>(ZoneType::Plopped));
+
+	auto city = std::make_unique<City>();
+	city->size = size;
+	city->occupants.reserve(static_cast<size_t>(size) * static_cast<size_t>(size) * occupantsPerCell);
+
+	for (int32_t z = 0; z < size; z++)
+	{
+		for (int32_t x = 0; x < size; x++)
+		{
+			for (uint32_t i = 0; i < occupantsPerCell; i++)
+			{
+				const uint32_t roll = percentDistribution(random);
+
+				if (roll < floraPercent)
+				{
+					city->occupants.push_back(std::make_unique<FakeOccupant>(kFloraOccupantType, 0, x, z));
+				}
+				else if (roll < floraPercent + networkPercent)
+				{
+					const uint32_t networkFlags = static_cast<uint32_t>(kNetworkTypes[networkDistribution(random)]);
+
+					city->occupants.push_back(std::make_unique<FakeOccupant>(kNetworkOccupantType, networkFlags, x, z));
+				}
+				else
+				{
+					const uint32_t type = (roll & 1) ? kBuildingOccupantType : kPropOccupantType;
+
+					city->occupants.push_back(std::make_unique<FakeOccupant>(type, 0, x, z));
+
+					if (city->lots.empty() || (roll % 4) == 0)
+					{
+						city->lots.push_back(std::make_unique<FakeLot>(static_cast<ZoneType>(zoneDistribution(random))));
+					}
+
+					city->lotManager.SetOccupantLot(city->occupants.back().get(), city->lots.back().get());
+				}
+			}
+		}
+	}
+
+	return city;
+}
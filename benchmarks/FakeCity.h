@@ -0,0 +1,107 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cISC4Lot.h"
+#include "cISC4LotManager.h"
+#include "cISC4NetworkOccupant.h"
+#include "cISC4Occupant.h"
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace FakeCity
+{
+	// Occupant type IDs used by the stand-in occupants.
+	// The flora type matches the value FloraOccupantFilter checks for.
+	constexpr uint32_t kFloraOccupantType = 0x74758926;
+	constexpr uint32_t kNetworkOccupantType = 0x088E1962;
+	constexpr uint32_t kBuildingOccupantType = 0x278128A0;
+	constexpr uint32_t kPropOccupantType = 0x2977AA47;
+
+	class FakeOccupant final : public cISC4Occupant, public cISC4NetworkOccupant
+	{
+	public:
+		FakeOccupant(uint32_t type, uint32_t networkFlags, int32_t cellX, int32_t cellZ);
+
+		bool QueryInterface(uint32_t riid, void** ppvObj) override;
+		uint32_t AddRef() override;
+		uint32_t Release() override;
+
+		uint32_t GetType() const override;
+
+		bool HasAnyNetworkFlag(uint32_t flags) const override;
+
+		int32_t GetCellX() const;
+		int32_t GetCellZ() const;
+
+	private:
+		uint32_t type;
+		uint32_t networkFlags;
+		int32_t cellX;
+		int32_t cellZ;
+		uint32_t refCount;
+	};
+
+	class FakeLot final : public cISC4Lot
+	{
+	public:
+		explicit FakeLot(cISC4ZoneManager::ZoneType zoneType);
+
+		bool QueryInterface(uint32_t riid, void** ppvObj) override;
+		uint32_t AddRef() override;
+		uint32_t Release() override;
+
+		cISC4ZoneManager::ZoneType GetZoneType() const override;
+
+	private:
+		cISC4ZoneManager::ZoneType zoneType;
+	};
+
+	class FakeLotManager final : public cISC4LotManager
+	{
+	public:
+		bool QueryInterface(uint32_t riid, void** ppvObj) override;
+		uint32_t AddRef() override;
+		uint32_t Release() override;
+
+		cISC4Lot* GetOccupantLot(cISC4Occupant* pOccupant) override;
+
+		void SetOccupantLot(cISC4Occupant* pOccupant, cISC4Lot* pLot);
+
+	private:
+		std::unordered_map<cISC4Occupant*, cISC4Lot*> occupantLots;
+	};
+
+	// A deterministic city tile populated with a mix of flora, network and lot occupants.
+	struct City
+	{
+		int32_t size;
+		std::vector<std::unique_ptr<FakeOccupant>> occupants;
+		std::vector<std::unique_ptr<FakeLot>> lots;
+		FakeLotManager lotManager;
+	};
+
+	// Creates a city that is size x size cells and has occupantsPerCell occupants in every cell.
+	// floraPercent and networkPercent control the occupant mix, the remainder are lot occupants.
+	std::unique_ptr<City> Create(int32_t size, uint32_t occupantsPerCell, uint32_t floraPercent, uint32_t networkPercent);
+}
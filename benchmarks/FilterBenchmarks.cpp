@@ -0,0 +1,313 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmarks.h"
+#include "Benchmark.h"
+#include "FakeCity.h"
+#include "DemolitionEffectAggregator.h"
+#include "DezoneKeepNetworksOccupantFilter.h"
+#include "ExpressionOccupantFilter.h"
+#include "FloraOccupantFilter.h"
+#include "GlobalCityPointers.h"
+#include "KeepNetworksOccupantFilter.h"
+#include "OccupantClassificationMemo.h"
+#include "OccupantDemolitionDriver.h"
+#include "OccupantSpatialIndex.h"
+#include "PredicateOccupantFilter.h"
+#include "RemoveNetworksOccupantFilter.h"
+#include "cRZAutoRefCount.h"
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <string_view>
+
+namespace
+{
+	// Applies the filter the same way cISC4Demolition::DemolishRegion does, the occupant type
+	// is checked first and the remaining occupants are passed to IsOccupantIncluded.
+	uint32_t CountIncludedOccupants(cISC4OccupantFilter* pFilter, const FakeCity::City& city)
+	{
+		uint32_t count = 0;
+
+		for (const auto& occupant : city.occupants)
+		{
+			cISC4Occupant* pOccupant = occupant.get();
+
+			if (pFilter->IsOccupantTypeIncluded(pOccupant->GetType())
+				&& pFilter->IsOccupantIncluded(pOccupant))
+			{
+				count++;
+			}
+		}
+
+		return count;
+	}
+
+	void RunFilterBenchmark(const std::string& name, cISC4OccupantFilter* pFilter, const FakeCity::City& city)
+	{
+		cRZAutoRefCount<cISC4OccupantFilter> filter(pFilter);
+
+		Benchmark::Run(name, [&]()
+		{
+			Benchmark::DoNotOptimize(CountIncludedOccupants(filter, city));
+		});
+	}
+
+	cISC4OccupantFilter* CreateExpressionFilter(std::string_view expression)
+	{
+		OccupantFilterProgram program;
+		std::string error;
+
+		if (!program.Compile(expression, error))
+		{
+			std::fprintf(stderr, "Failed to compile '%.*s': %s\n", static_cast<int>(expression.size()), expression.data(), error.c_str());
+			std::abort();
+		}
+
+		return new ExpressionOccupantFilter(program);
+	}
+
+	void BuildSpatialIndex(const FakeCity::City& city, OccupantSpatialIndex& index)
+	{
+		index.Reset(city.size, city.size);
+
+		for (const auto& occupant : city.occupants)
+		{
+			OccupantSpatialIndex::Entry entry{};
+			entry.pOccupant = occupant.get();
+			entry.category = OccupantCategory::Other;
+
+			if (occupant->GetType() == FakeCity::kFloraOccupantType)
+			{
+				entry.category = OccupantCategory::Flora;
+			}
+			else if (occupant->HasAnyNetworkFlag(static_cast<uint32_t>(NetworkTypeFlags::AllTransportationNetworks)))
+			{
+				entry.category = OccupantCategory::Network;
+			}
+			else if (cISC4Lot* pLot = spLotManager->GetOccupantLot(occupant.get()))
+			{
+				entry.category = OccupantCategory::Lot;
+				entry.zoneType = pLot->GetZoneType();
+			}
+
+			const int32_t x = occupant->GetCellX();
+			const int32_t z = occupant->GetCellZ();
+
+			index.Insert(SC4Rect<int32_t>{ x, z, x, z }, entry);
+		}
+	}
+
+	// Removes the cells without included occupants from a full tile selection and applies
+	// the filter to the occupants of the remaining cells.
+	void RunIndexedFilterBenchmark(
+		const std::string& name,
+		cISC4OccupantFilter* pFilter,
+		uint32_t categoryFlags,
+		const FakeCity::City& city,
+		OccupantSpatialIndex& index)
+	{
+		cRZAutoRefCount<cISC4OccupantFilter> filter(pFilter);
+		BitsetCellRegion region;
+
+		Benchmark::Run(name, [&]()
+		{
+			region.Reset(0, 0, city.size - 1, city.size - 1);
+
+			for (uint32_t z = 0; z < region.GetHeight(); z++)
+			{
+				region.FillRowSpan(z, 0, city.size - 1, true);
+			}
+
+			index.RemoveCellsWithoutOccupants(region, categoryFlags);
+
+			uint32_t count = 0;
+
+			for (int32_t z = 0; z < city.size; z++)
+			{
+				for (int32_t x = 0; x < city.size; x++)
+				{
+					if (region.GetValue(static_cast<uint32_t>(x), static_cast<uint32_t>(z)))
+					{
+						for (const OccupantSpatialIndex::Entry& entry : index.GetCellOccupants(x, z))
+						{
+							if (filter->IsOccupantTypeIncluded(entry.pOccupant->GetType())
+								&& filter->IsOccupantIncluded(entry.pOccupant))
+							{
+								count++;
+							}
+						}
+					}
+				}
+			}
+
+			Benchmark::DoNotOptimize(count);
+		});
+	}
+
+	// Passes the occupants of a full tile selection through the demolition driver's filter
+	// in the order that the game's demolition loop visits them.
+	void RunDriverBenchmark(
+		const std::string& name,
+		cISC4OccupantFilter* pFilter,
+		const FakeCity::City& city,
+		const OccupantSpatialIndex& index)
+	{
+		cRZAutoRefCount<cISC4OccupantFilter> filter(pFilter);
+		OccupantDemolitionDriver driver;
+
+		Benchmark::Run(name, [&]()
+		{
+			cISC4OccupantFilter* pDriverFilter = driver.Begin(filter);
+			uint32_t count = 0;
+
+			for (int32_t z = 0; z < city.size; z++)
+			{
+				for (int32_t x = 0; x < city.size; x++)
+				{
+					for (const OccupantSpatialIndex::Entry& entry : index.GetCellOccupants(x, z))
+					{
+						if (pDriverFilter->IsOccupantTypeIncluded(entry.pOccupant->GetType())
+							&& pDriverFilter->IsOccupantIncluded(entry.pOccupant))
+						{
+							count++;
+						}
+					}
+				}
+			}
+
+			Benchmark::DoNotOptimize(count);
+		});
+	}
+
+	void RunEffectAggregatorBenchmark(
+		const std::string& name,
+		uint32_t categoryFlags,
+		const FakeCity::City& city,
+		const OccupantSpatialIndex& index)
+	{
+		BitsetCellRegion selectedCells(0, 0, city.size - 1, city.size - 1);
+		DemolitionEffectAggregator aggregator;
+
+		for (uint32_t z = 0; z < selectedCells.GetHeight(); z++)
+		{
+			selectedCells.FillRowSpan(z, 0, city.size - 1, true);
+		}
+
+		Benchmark::Run(name, [&]()
+		{
+			aggregator.Aggregate(index, selectedCells, categoryFlags, 32);
+			Benchmark::DoNotOptimize(aggregator.GetEffectCount());
+		});
+	}
+
+	void RunWorkloadBenchmarks(const char* workloadName, const FakeCity::City& city)
+	{
+		const std::string prefix = std::string("filter/") + workloadName + '/';
+
+		RunFilterBenchmark(prefix + "flora", new FloraOccupantFilter(), city);
+		RunFilterBenchmark(prefix + "keep_networks", new KeepNetworksOccupantFilter(nullptr), city);
+		RunFilterBenchmark(prefix + "remove_networks", new RemoveNetworksOccupantFilter(nullptr), city);
+		RunFilterBenchmark(prefix + "dezone_keep_networks", new DezoneKeepNetworksOccupantFilter(nullptr), city);
+
+		// The memo is shared by all of the iterations, this matches the repeated preview
+		// dry runs of a drag over the same cells.
+		OccupantClassificationMemo memo;
+
+		RunFilterBenchmark(prefix + "keep_networks_memo", new KeepNetworksOccupantFilter(&memo), city);
+		RunFilterBenchmark(prefix + "dezone_keep_networks_memo", new DezoneKeepNetworksOccupantFilter(&memo), city);
+
+		// A filter that is allocated for every DemolishRegion call, compared to the long-lived
+		// instance that the bulldoze tool reuses for each preview update. Both start each
+		// iteration with an empty memo, as the first preview update of a drag does.
+		Benchmark::Run(prefix + "dezone_keep_networks_per_call", [&]()
+		{
+			memo.Clear();
+
+			cRZAutoRefCount<cISC4OccupantFilter> filter(new DezoneKeepNetworksOccupantFilter(&memo));
+
+			Benchmark::DoNotOptimize(CountIncludedOccupants(filter, city));
+		});
+
+		{
+			cRZAutoRefCount<DezoneKeepNetworksOccupantFilter> filter(new DezoneKeepNetworksOccupantFilter(&memo));
+
+			Benchmark::Run(prefix + "dezone_keep_networks_reused", [&]()
+			{
+				memo.Clear();
+				filter->ClearLotZoneTypes();
+
+				Benchmark::DoNotOptimize(CountIncludedOccupants(filter, city));
+			});
+		}
+
+		// The compiled expression equivalents of the built-in filters.
+		RunFilterBenchmark(prefix + "expression/flora", CreateExpressionFilter("flora"), city);
+		RunFilterBenchmark(prefix + "expression/keep_networks", CreateExpressionFilter("NOT network"), city);
+		RunFilterBenchmark(prefix + "expression/remove_networks", CreateExpressionFilter("network"), city);
+		RunFilterBenchmark(
+			prefix + "expression/dezone_keep_networks",
+			CreateExpressionFilter("lot zone in {rci} AND NOT network"),
+			city);
+		RunFilterBenchmark(
+			prefix + "expression/flora_or_street",
+			CreateExpressionFilter("flora OR (network AND NOT (road OR highway OR rail))"),
+			city);
+
+		// A predicate chain for the same selection as the flora_or_street expression.
+		using FloraOrStreetOccupantFilter = PredicateOccupantFilter<
+			Or<IsFloraType,
+				And<HasNetworkFlags<NetworkTypeFlags::AllTransportationNetworks>,
+					Not<HasNetworkFlags<NetworkTypeFlags::Road | NetworkTypeFlags::Highway | NetworkTypeFlags::Rail>>>>>;
+
+		RunFilterBenchmark(prefix + "predicate/flora_or_street", new FloraOrStreetOccupantFilter(), city);
+
+		OccupantSpatialIndex index;
+		BuildSpatialIndex(city, index);
+
+		RunIndexedFilterBenchmark(prefix + "flora_indexed", new FloraOccupantFilter(), OccupantCategoryFlagFlora, city, index);
+		RunIndexedFilterBenchmark(
+			prefix + "remove_networks_indexed",
+			new RemoveNetworksOccupantFilter(nullptr),
+			OccupantCategoryFlagNetwork,
+			city,
+			index);
+
+		RunDriverBenchmark(prefix + "driver/flora", new FloraOccupantFilter(), city, index);
+		RunDriverBenchmark(prefix + "driver/remove_networks", new RemoveNetworksOccupantFilter(nullptr), city, index);
+		RunEffectAggregatorBenchmark(prefix + "effects/flora", OccupantCategoryFlagFlora, city, index);
+	}
+}
+
+void Benchmarks::RunFilterBenchmarks()
+{
+	// A 64x64 selection with 4 occupants per cell.
+	const auto forested = FakeCity::Create(64, 4, 90, 5);
+	const auto downtown = FakeCity::Create(64, 4, 10, 20);
+
+	spLotManager = &forested->lotManager;
+	RunWorkloadBenchmarks("forested", *forested);
+
+	spLotManager = &downtown->lotManager;
+	RunWorkloadBenchmarks("downtown", *downtown);
+
+	spLotManager = nullptr;
+}
@@ -0,0 +1,148 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmarks.h"
+#include "Benchmark.h"
+#include "OccupantSpatialIndex.h"
+#include "PreviewScheduler.h"
+#include <random>
+#include <string>
+#include <vector>
+
+namespace
+{
+	void RunSchedulerBenchmarks(size_t pathVertexCount)
+	{
+		const std::string suffix = "/v" + std::to_string(pathVertexCount);
+
+		const SC4Rect<int32_t> bounds{ 0, 0, 255, 255 };
+		const std::vector<uint64_t> pathVertices(pathVertexCount, 0x0000001000000020ull);
+
+		auto createKey = [&](uint64_t mode)
+		{
+			uint64_t key = PreviewScheduler::CombineKey(PreviewScheduler::kInitialKey, mode);
+
+			for (uint64_t vertex : pathVertices)
+			{
+				key = PreviewScheduler::CombineKey(key, vertex);
+			}
+
+			return key;
+		};
+
+		// The cost of checking an unchanged selection, this replaces a dry run demolition
+		// for every mouse move that does not change the selected cells.
+		{
+			PreviewScheduler scheduler;
+			bool result = false;
+			int64_t totalCost = 0;
+
+			if (!scheduler.TryGetResult(bounds, createKey(0), 0, result, totalCost))
+			{
+				scheduler.SetResult(true, 100);
+			}
+
+			Benchmark::Run("preview_scheduler/unchanged" + suffix, [&]()
+			{
+				const bool cached = scheduler.TryGetResult(bounds, createKey(0), 0, result, totalCost);
+				Benchmark::DoNotOptimize(cached);
+				Benchmark::DoNotOptimize(totalCost);
+			});
+		}
+
+		// A selection that changes for every update within the same frame interval.
+		{
+			PreviewScheduler scheduler;
+			bool result = false;
+			int64_t totalCost = 0;
+			uint64_t mode = 0;
+
+			if (!scheduler.TryGetResult(bounds, createKey(mode), 0, result, totalCost))
+			{
+				scheduler.SetResult(true, 100);
+			}
+
+			Benchmark::Run("preview_scheduler/coalesced" + suffix, [&]()
+			{
+				mode++;
+				const bool cached = scheduler.TryGetResult(bounds, createKey(mode), 0, result, totalCost);
+				Benchmark::DoNotOptimize(cached);
+				Benchmark::DoNotOptimize(totalCost);
+			});
+		}
+	}
+
+	void RunSpatialIndexBenchmarks(int32_t citySize, uint32_t occupantsPerCell)
+	{
+		const std::string suffix = "/" + std::to_string(citySize) + "x" + std::to_string(citySize);
+
+		OccupantSpatialIndex index;
+		index.Reset(citySize, citySize);
+
+		std::mt19937 random(citySize);
+		uintptr_t occupantAddress = 0;
+
+		for (int32_t z = 0; z < citySize; z++)
+		{
+			for (int32_t x = 0; x < citySize; x++)
+			{
+				for (uint32_t i = 0; i < occupantsPerCell; i++)
+				{
+					OccupantSpatialIndex::Entry entry{};
+					// The index only compares the occupant pointers.
+					occupantAddress += 8;
+					entry.pOccupant = reinterpret_cast<cISC4Occupant*>(occupantAddress);
+					entry.category = static_cast<OccupantCategory>(random() % kOccupantCategoryCount);
+
+					index.Insert(SC4Rect<int32_t>{ x, z, x, z }, entry);
+				}
+			}
+		}
+
+		// A selection without occupants tests every cell before it returns.
+		OccupantSpatialIndex emptyIndex;
+		emptyIndex.Reset(citySize, citySize);
+
+		// A full tile selection.
+		const SC4Rect<int32_t> rect{ 0, 0, citySize - 1, citySize - 1 };
+		const uint32_t floraFlag = GetOccupantCategoryFlag(OccupantCategory::Flora);
+
+		Benchmark::Run("spatial_index/has_occupants" + suffix, [&]()
+		{
+			const bool hasOccupants = index.HasOccupants(rect, floraFlag);
+			Benchmark::DoNotOptimize(hasOccupants);
+		});
+
+		Benchmark::Run("spatial_index/has_occupants_empty" + suffix, [&]()
+		{
+			const bool hasOccupants = emptyIndex.HasOccupants(rect, floraFlag);
+			Benchmark::DoNotOptimize(hasOccupants);
+		});
+	}
+}
+
+void Benchmarks::RunPreviewBenchmarks()
+{
+	RunSchedulerBenchmarks(0);
+	RunSchedulerBenchmarks(64);
+	RunSpatialIndexBenchmarks(64, 4);
+	RunSpatialIndexBenchmarks(256, 4);
+}
@@ -0,0 +1,217 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "Benchmarks.h"
+#include "Benchmark.h"
+#include "CellRegionRasterizer.h"
+#include "DiagonalRegionCache.h"
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// Mirrors the work the demolish hooks do for each selection update: rasterize the
+	// diagonal and copy it into the view control's existing region.
+	void CreateAndCopyDiagonal(SC4CellRegion<int32_t>& existing, int32_t thickness)
+	{
+		const auto& bounds = existing.bounds;
+
+		SC4CellRegion<int32_t> diagonalRegion = CellRegionRasterizer::CreateDiagonalRegion(
+			bounds.topLeftX,
+			bounds.topLeftY,
+			bounds.bottomRightX,
+			bounds.bottomRightY,
+			thickness,
+			bounds.topLeftX,
+			bounds.topLeftY);
+
+		const uint32_t width = static_cast<uint32_t>(bounds.bottomRightX - bounds.topLeftX + 1);
+		const uint32_t height = static_cast<uint32_t>(bounds.bottomRightY - bounds.topLeftY + 1);
+
+		for (uint32_t x = 0; x < width; x++)
+		{
+			for (uint32_t z = 0; z < height; z++)
+			{
+				existing.cellMap.SetValue(x, z, diagonalRegion.cellMap.GetValue(x, z));
+			}
+		}
+	}
+
+	void RunDiagonalBenchmarks(int32_t size, int32_t thickness)
+	{
+		const std::string suffix = '/' + std::to_string(size) + 'x' + std::to_string(size) + "/t" + std::to_string(thickness);
+		const int32_t max = size - 1;
+
+		Benchmark::Run("diagonal/create" + suffix, [&]()
+		{
+			SC4CellRegion<int32_t> region = CellRegionRasterizer::CreateDiagonalRegion(0, 0, max, max, thickness, 0, 0);
+			Benchmark::DoNotOptimize(region);
+		});
+
+		SC4CellRegion<int32_t> existing(0, 0, max, max, true);
+
+		Benchmark::Run("diagonal/preview_update" + suffix, [&]()
+		{
+			CreateAndCopyDiagonal(existing, thickness);
+			Benchmark::DoNotOptimize(existing);
+		});
+
+		Benchmark::Run("diagonal/rasterize_into" + suffix, [&]()
+		{
+			CellRegionRasterizer::RasterizeDiagonal(existing, thickness, 0, 0);
+			Benchmark::DoNotOptimize(existing);
+		});
+
+		// The hooks request the same region several times for each selection update.
+		DiagonalRegionCache cache;
+
+		Benchmark::Run("diagonal/preview_update_cached" + suffix, [&]()
+		{
+			cache.Apply(existing, thickness, 0, 0);
+			Benchmark::DoNotOptimize(existing);
+		});
+
+		// Adjusting the thickness with the mouse wheel keeps the same bounds, so only
+		// the cells that differ between the two lines need to be updated.
+		int32_t wheelThickness = thickness;
+
+		Benchmark::Run("diagonal/preview_update_thickness_change" + suffix, [&]()
+		{
+			wheelThickness = wheelThickness == thickness ? thickness + 1 : thickness;
+
+			cache.Apply(existing, wheelThickness, 0, 0);
+			Benchmark::DoNotOptimize(existing);
+		});
+	}
+
+	void RunPolygonBenchmarks(int32_t size, int32_t vertexCount)
+	{
+		const std::string suffix = '/' + std::to_string(size) + 'x' + std::to_string(size) + "/v" + std::to_string(vertexCount);
+
+		// A star shaped polygon, the concave vertices give each row several spans.
+		std::vector<CellRegionRasterizer::CellPoint> vertices;
+		const double radius = (size - 1) / 2.0;
+
+		for (int32_t i = 0; i < vertexCount; i++)
+		{
+			const double angle = (6.283185307179586 * i) / vertexCount;
+			const double scale = (i % 2) == 0 ? 1.0 : 0.5;
+
+			vertices.push_back(CellRegionRasterizer::CellPoint
+			{
+				static_cast<int32_t>(std::lround(radius + std::cos(angle) * radius * scale)),
+				static_cast<int32_t>(std::lround(radius + std::sin(angle) * radius * scale)),
+			});
+		}
+
+		BitsetCellRegion region;
+
+		Benchmark::Run("polygon/rasterize" + suffix, [&]()
+		{
+			CellRegionRasterizer::RasterizePolygon(vertices, region);
+			Benchmark::DoNotOptimize(region);
+		});
+
+		Benchmark::Run("polygon/rasterize_to_cell_region" + suffix, [&]()
+		{
+			CellRegionRasterizer::RasterizePolygon(vertices, region);
+			SC4CellRegion<int32_t> cellRegion = region.ToCellRegion();
+			Benchmark::DoNotOptimize(cellRegion);
+		});
+	}
+
+	void RunEllipseBenchmarks(int32_t radius)
+	{
+		const std::string suffix = "/r" + std::to_string(radius);
+
+		std::vector<CellRegionRasterizer::RowSpan> spans;
+
+		Benchmark::Run("ellipse/spans" + suffix, [&]()
+		{
+			CellRegionRasterizer::GetEllipseSpans(radius * 2 + 1, radius * 2 + 1, spans);
+			Benchmark::DoNotOptimize(spans);
+		});
+
+		BitsetCellRegion region;
+
+		Benchmark::Run("ellipse/rasterize" + suffix, [&]()
+		{
+			CellRegionRasterizer::RasterizeEllipse(-radius, -radius, radius, radius, region);
+			Benchmark::DoNotOptimize(region);
+		});
+	}
+
+	void RunLineBenchmarks(int32_t length, int32_t width)
+	{
+		const std::string suffix = "/l" + std::to_string(length) + "/w" + std::to_string(width);
+
+		// A shallow line, so that the width is added across several rows.
+		const CellRegionRasterizer::CellPoint start{ 0, 0 };
+		const CellRegionRasterizer::CellPoint end{ length, length / 3 };
+
+		BitsetCellRegion region;
+
+		Benchmark::Run("line/rasterize" + suffix, [&]()
+		{
+			CellRegionRasterizer::RasterizeLine(start, end, width, region);
+			Benchmark::DoNotOptimize(region);
+		});
+	}
+
+	void RunPolylineBenchmarks(int32_t segmentCount, int32_t width)
+	{
+		const std::string suffix = "/s" + std::to_string(segmentCount) + "/w" + std::to_string(width);
+
+		// A zig-zag path, so that the segment bounds overlap.
+		std::vector<CellRegionRasterizer::CellPoint> vertices;
+
+		for (int32_t i = 0; i <= segmentCount; i++)
+		{
+			vertices.push_back(CellRegionRasterizer::CellPoint{ i * 16, (i & 1) ? 48 : 0 });
+		}
+
+		BitsetCellRegion region;
+
+		Benchmark::Run("polyline/rasterize" + suffix, [&]()
+		{
+			CellRegionRasterizer::RasterizePolyline(vertices, width, region);
+			Benchmark::DoNotOptimize(region);
+		});
+	}
+}
+
+void Benchmarks::RunRasterizerBenchmarks()
+{
+	RunDiagonalBenchmarks(64, 1);
+	RunDiagonalBenchmarks(200, 1);
+	RunDiagonalBenchmarks(200, 9);
+	RunDiagonalBenchmarks(256, -9);
+	RunDiagonalBenchmarks(256, 64);
+	RunPolygonBenchmarks(64, 8);
+	RunPolygonBenchmarks(256, 32);
+	RunEllipseBenchmarks(8);
+	RunEllipseBenchmarks(128);
+	RunLineBenchmarks(200, 1);
+	RunLineBenchmarks(200, 16);
+	RunPolylineBenchmarks(16, 1);
+	RunPolylineBenchmarks(16, 8);
+}
@@ -19,14 +19,16 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "KeepNetworksOccupantFilter.h"
+// Host build stand-in for the gzcom-dll header of the same name.
+// Only the members used by the platform-independent bulldoze code are declared.
 
-KeepNetworksOccupantFilter::KeepNetworksOccupantFilter(NetworkTypeFlags networkFlags)
-	: NetworkOccupantFilterBase(networkFlags)
-{
-}
+#pragma once
 
-bool KeepNetworksOccupantFilter::IsOccupantIncluded(cISC4Occupant* pOccupant)
+template <typename T>
+struct SC4Rect
 {
-	return !IsNetworkOccupant(pOccupant);
-}
\ No newline at end of file
+	T topLeftX;
+	T topLeftY;
+	T bottomRightX;
+	T bottomRightY;
+};
@@ -19,14 +19,14 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "RemoveNetworksOccupantFilter.h"
+// Host build stand-in for the gzcom-dll header of the same name.
+// Only the members used by the platform-independent bulldoze code are declared.
 
-RemoveNetworksOccupantFilter::RemoveNetworksOccupantFilter(NetworkTypeFlags networkFlags)
-	: NetworkOccupantFilterBase(networkFlags)
-{
-}
+#pragma once
+#include "cISC4ZoneManager.h"
 
-bool RemoveNetworksOccupantFilter::IsOccupantIncluded(cISC4Occupant* pOccupant)
+class cISC4Lot : public cIGZUnknown
 {
-	return IsNetworkOccupant(pOccupant);
-}
+public:
+	virtual cISC4ZoneManager::ZoneType GetZoneType() const = 0;
+};
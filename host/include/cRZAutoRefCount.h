@@ -0,0 +1,108 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Host build stand-in for the gzcom-dll header of the same name.
+// Only the members used by the platform-independent bulldoze code are declared.
+
+#pragma once
+
+template <typename T>
+class cRZAutoRefCount
+{
+public:
+	cRZAutoRefCount() : pObject(nullptr)
+	{
+	}
+
+	cRZAutoRefCount(T* pOther) : pObject(pOther)
+	{
+		if (pObject)
+		{
+			pObject->AddRef();
+		}
+	}
+
+	cRZAutoRefCount(const cRZAutoRefCount<T>& other) : pObject(other.pObject)
+	{
+		if (pObject)
+		{
+			pObject->AddRef();
+		}
+	}
+
+	~cRZAutoRefCount()
+	{
+		if (pObject)
+		{
+			pObject->Release();
+		}
+	}
+
+	cRZAutoRefCount<T>& operator=(T* pOther)
+	{
+		if (pOther != pObject)
+		{
+			if (pOther)
+			{
+				pOther->AddRef();
+			}
+
+			T* pOld = pObject;
+			pObject = pOther;
+
+			if (pOld)
+			{
+				pOld->Release();
+			}
+		}
+
+		return *this;
+	}
+
+	cRZAutoRefCount<T>& operator=(const cRZAutoRefCount<T>& other)
+	{
+		return *this = other.pObject;
+	}
+
+	T* operator->() const
+	{
+		return pObject;
+	}
+
+	operator T*() const
+	{
+		return pObject;
+	}
+
+	void** AsPPVoid()
+	{
+		if (pObject)
+		{
+			pObject->Release();
+			pObject = nullptr;
+		}
+
+		return reinterpret_cast<void**>(&pObject);
+	}
+
+private:
+	T* pObject;
+};
@@ -0,0 +1,42 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Host build stand-in for the gzcom-dll header of the same name.
+// The cells are stored as one byte per cell in row-major order, matching the game's layout.
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+class cRZCellMap
+{
+public:
+	cRZCellMap();
+	cRZCellMap(uint32_t width, uint32_t height, bool initialValue);
+
+	bool GetValue(uint32_t x, uint32_t z) const;
+	void SetValue(uint32_t x, uint32_t z, bool value);
+
+private:
+	uint32_t width;
+	uint32_t height;
+	std::vector<uint8_t> cells;
+};
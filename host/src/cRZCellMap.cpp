@@ -0,0 +1,45 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cRZCellMap.h"
+#include <cstddef>
+
+cRZCellMap::cRZCellMap()
+	: width(0), height(0), cells()
+{
+}
+
+cRZCellMap::cRZCellMap(uint32_t width, uint32_t height, bool initialValue)
+	: width(width),
+	  height(height),
+	  cells(static_cast<size_t>(width) * static_cast<size_t>(height), initialValue ? 1 : 0)
+{
+}
+
+bool cRZCellMap::GetValue(uint32_t x, uint32_t z) const
+{
+	return cells[(static_cast<size_t>(z) * width) + x] != 0;
+}
+
+void cRZCellMap::SetValue(uint32_t x, uint32_t z, bool value)
+{
+	cells[(static_cast<size_t>(z) * width) + x] = value ? 1 : 0;
+}
@@ -0,0 +1,90 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "cSC4BaseOccupantFilter.h"
+
+static const uint32_t GZIID_cIGZUnknown = 0x00000001;
+static const uint32_t GZIID_cISC4OccupantFilter = 0xC43FA2F6;
+
+cSC4BaseOccupantFilter::cSC4BaseOccupantFilter()
+	: refCount(0)
+{
+}
+
+cSC4BaseOccupantFilter::~cSC4BaseOccupantFilter()
+{
+}
+
+bool cSC4BaseOccupantFilter::QueryInterface(uint32_t riid, void** ppvObj)
+{
+	if (riid == GZIID_cISC4OccupantFilter)
+	{
+		*ppvObj = static_cast<cISC4OccupantFilter*>(this);
+		AddRef();
+
+		return true;
+	}
+	else if (riid == GZIID_cIGZUnknown)
+	{
+		*ppvObj = static_cast<cIGZUnknown*>(this);
+		AddRef();
+
+		return true;
+	}
+
+	return false;
+}
+
+uint32_t cSC4BaseOccupantFilter::AddRef()
+{
+	return ++refCount;
+}
+
+uint32_t cSC4BaseOccupantFilter::Release()
+{
+	if (refCount > 0)
+	{
+		--refCount;
+	}
+
+	if (refCount == 0)
+	{
+		delete this;
+		return 0;
+	}
+
+	return refCount;
+}
+
+bool cSC4BaseOccupantFilter::IsOccupantIncluded(cISC4Occupant* pOccupant)
+{
+	return true;
+}
+
+bool cSC4BaseOccupantFilter::IsOccupantTypeIncluded(uint32_t type)
+{
+	return true;
+}
+
+bool cSC4BaseOccupantFilter::IsPropertyHolderIncluded(cISCPropertyHolder* pProperties)
+{
+	return true;
+}
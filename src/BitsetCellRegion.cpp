@@ -0,0 +1,528 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BitsetCellRegion.h"
+#include "BitsetKernels.h"
+#include <algorithm>
+#include <bit>
+
+namespace
+{
+	constexpr uint32_t kBitsPerWord = 64;
+
+	uint32_t GetWordCount(uint32_t bitCount)
+	{
+		return (bitCount + (kBitsPerWord - 1)) / kBitsPerWord;
+	}
+
+	// Gets a mask with the bits in [first, last] of a word set.
+	uint64_t GetBitMask(uint32_t first, uint32_t last)
+	{
+		const uint64_t upperBits = ~uint64_t(0) << first;
+		const uint64_t lowerBits = ~uint64_t(0) >> (kBitsPerWord - 1 - last);
+
+		return upperBits & lowerBits;
+	}
+
+	// Reads the 64 bits of a row that start at the specified bit offset.
+	// The bits outside of the row are zero.
+	uint64_t ReadBits(const uint64_t* row, uint32_t wordCount, int64_t bitOffset)
+	{
+		if (bitOffset <= -static_cast<int64_t>(kBitsPerWord)
+			|| bitOffset >= static_cast<int64_t>(wordCount) * kBitsPerWord)
+		{
+			return 0;
+		}
+
+		if (bitOffset < 0)
+		{
+			return row[0] << static_cast<uint32_t>(-bitOffset);
+		}
+
+		const uint32_t wordIndex = static_cast<uint32_t>(bitOffset / kBitsPerWord);
+		const uint32_t shift = static_cast<uint32_t>(bitOffset % kBitsPerWord);
+
+		uint64_t value = row[wordIndex] >> shift;
+
+		if (shift != 0 && (wordIndex + 1) < wordCount)
+		{
+			value |= row[wordIndex + 1] << (kBitsPerWord - shift);
+		}
+
+		return value;
+	}
+}
+
+BitsetCellRegion::BitsetCellRegion()
+	: bounds{ 0, 0, -1, -1 },
+	  width(0),
+	  height(0),
+	  wordsPerRow(0),
+	  words()
+{
+}
+
+BitsetCellRegion::BitsetCellRegion(int32_t minX, int32_t minZ, int32_t maxX, int32_t maxZ)
+	: BitsetCellRegion()
+{
+	Reset(minX, minZ, maxX, maxZ);
+}
+
+BitsetCellRegion::BitsetCellRegion(const SC4CellRegion<int32_t>& region)
+	: BitsetCellRegion()
+{
+	CopyFrom(region);
+}
+
+void BitsetCellRegion::Reset(int32_t minX, int32_t minZ, int32_t maxX, int32_t maxZ)
+{
+	bounds = SC4Rect<int32_t>{ minX, minZ, maxX, maxZ };
+
+	if (maxX >= minX && maxZ >= minZ)
+	{
+		width = static_cast<uint32_t>(maxX - minX + 1);
+		height = static_cast<uint32_t>(maxZ - minZ + 1);
+	}
+	else
+	{
+		width = 0;
+		height = 0;
+	}
+
+	wordsPerRow = GetWordCount(width);
+	words.resize(static_cast<size_t>(wordsPerRow) * height);
+	Clear();
+}
+
+const SC4Rect<int32_t>& BitsetCellRegion::GetBounds() const
+{
+	return bounds;
+}
+
+uint32_t BitsetCellRegion::GetWidth() const
+{
+	return width;
+}
+
+uint32_t BitsetCellRegion::GetHeight() const
+{
+	return height;
+}
+
+bool BitsetCellRegion::GetValue(uint32_t x, uint32_t z) const
+{
+	if (x >= width || z >= height)
+	{
+		return false;
+	}
+
+	return (GetRow(z)[x / kBitsPerWord] >> (x % kBitsPerWord)) & 1;
+}
+
+void BitsetCellRegion::SetValue(uint32_t x, uint32_t z, bool value)
+{
+	if (x >= width || z >= height)
+	{
+		return;
+	}
+
+	uint64_t& word = GetRow(z)[x / kBitsPerWord];
+	const uint64_t mask = uint64_t(1) << (x % kBitsPerWord);
+
+	if (value)
+	{
+		word |= mask;
+	}
+	else
+	{
+		word &= ~mask;
+	}
+}
+
+void BitsetCellRegion::FillRowSpan(uint32_t z, int32_t start, int32_t end, bool value)
+{
+	start = std::max(start, 0);
+	end = std::min(end, static_cast<int32_t>(width) - 1);
+
+	if (z >= height || start > end)
+	{
+		return;
+	}
+
+	uint64_t* row = GetRow(z);
+
+	const uint32_t firstWord = static_cast<uint32_t>(start) / kBitsPerWord;
+	const uint32_t lastWord = static_cast<uint32_t>(end) / kBitsPerWord;
+	const uint32_t firstBit = static_cast<uint32_t>(start) % kBitsPerWord;
+	const uint32_t lastBit = static_cast<uint32_t>(end) % kBitsPerWord;
+
+	for (uint32_t i = firstWord; i <= lastWord; i++)
+	{
+		const uint64_t mask = GetBitMask(
+			i == firstWord ? firstBit : 0,
+			i == lastWord ? lastBit : kBitsPerWord - 1);
+
+		if (value)
+		{
+			row[i] |= mask;
+		}
+		else
+		{
+			row[i] &= ~mask;
+		}
+	}
+}
+
+void BitsetCellRegion::Clear()
+{
+	BitsetKernels::GetKernels().fill(words.data(), words.size(), 0);
+}
+
+void BitsetCellRegion::CopyFrom(const BitsetCellRegion& other)
+{
+	if (HasSameRowLayout(other) && bounds.topLeftY == other.bounds.topLeftY && height == other.height)
+	{
+		BitsetKernels::GetKernels().copy(words.data(), other.words.data(), words.size());
+	}
+	else
+	{
+		Clear();
+		Combine(other, Operation::Unite);
+	}
+}
+
+void BitsetCellRegion::Unite(const BitsetCellRegion& other)
+{
+	Combine(other, Operation::Unite);
+}
+
+void BitsetCellRegion::Intersect(const BitsetCellRegion& other)
+{
+	Combine(other, Operation::Intersect);
+}
+
+void BitsetCellRegion::Subtract(const BitsetCellRegion& other)
+{
+	Combine(other, Operation::Subtract);
+}
+
+uint64_t BitsetCellRegion::PopCount() const
+{
+	return BitsetKernels::GetKernels().popCount(words.data(), words.size());
+}
+
+uint64_t BitsetCellRegion::PopCountRow(uint32_t z) const
+{
+	return BitsetKernels::GetKernels().popCount(GetRow(z), wordsPerRow);
+}
+
+bool BitsetCellRegion::GetSetCellBounds(SC4Rect<int32_t>& setCellBounds) const
+{
+	bool found = false;
+	uint32_t minX = width;
+	uint32_t maxX = 0;
+	uint32_t minZ = 0;
+	uint32_t maxZ = 0;
+
+	for (uint32_t z = 0; z < height; z++)
+	{
+		const uint64_t* row = GetRow(z);
+
+		for (uint32_t i = 0; i < wordsPerRow; i++)
+		{
+			const uint64_t word = row[i];
+
+			if (word != 0)
+			{
+				minX = std::min(minX, i * kBitsPerWord + static_cast<uint32_t>(std::countr_zero(word)));
+				maxX = std::max(maxX, i * kBitsPerWord + (kBitsPerWord - 1) - static_cast<uint32_t>(std::countl_zero(word)));
+
+				if (!found)
+				{
+					minZ = z;
+					found = true;
+				}
+
+				maxZ = z;
+			}
+		}
+	}
+
+	if (found)
+	{
+		setCellBounds = SC4Rect<int32_t>
+		{
+			bounds.topLeftX + static_cast<int32_t>(minX),
+			bounds.topLeftY + static_cast<int32_t>(minZ),
+			bounds.topLeftX + static_cast<int32_t>(maxX),
+			bounds.topLeftY + static_cast<int32_t>(maxZ),
+		};
+	}
+
+	return found;
+}
+
+bool BitsetCellRegion::HasSetCells(const SC4Rect<int32_t>& rect) const
+{
+	const int32_t minX = std::max(rect.topLeftX, bounds.topLeftX) - bounds.topLeftX;
+	const int32_t minZ = std::max(rect.topLeftY, bounds.topLeftY) - bounds.topLeftY;
+	const int32_t maxX = std::min(rect.bottomRightX - bounds.topLeftX, static_cast<int32_t>(width) - 1);
+	const int32_t maxZ = std::min(rect.bottomRightY - bounds.topLeftY, static_cast<int32_t>(height) - 1);
+
+	if (minX > maxX || minZ > maxZ)
+	{
+		return false;
+	}
+
+	const uint32_t firstWord = static_cast<uint32_t>(minX) / kBitsPerWord;
+	const uint32_t lastWord = static_cast<uint32_t>(maxX) / kBitsPerWord;
+
+	for (uint32_t z = static_cast<uint32_t>(minZ); z <= static_cast<uint32_t>(maxZ); z++)
+	{
+		const uint64_t* row = GetRow(z);
+
+		for (uint32_t i = firstWord; i <= lastWord; i++)
+		{
+			const uint32_t first = i == firstWord ? static_cast<uint32_t>(minX) % kBitsPerWord : 0;
+			const uint32_t last = i == lastWord ? static_cast<uint32_t>(maxX) % kBitsPerWord : kBitsPerWord - 1;
+
+			if ((row[i] & GetBitMask(first, last)) != 0)
+			{
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void BitsetCellRegion::CopyFrom(const SC4CellRegion<int32_t>& region)
+{
+	const auto& regionBounds = region.bounds;
+
+	Reset(regionBounds.topLeftX, regionBounds.topLeftY, regionBounds.bottomRightX, regionBounds.bottomRightY);
+
+	for (uint32_t z = 0; z < height; z++)
+	{
+		uint64_t* row = GetRow(z);
+
+		for (uint32_t x = 0; x < width; x++)
+		{
+			if (region.cellMap.GetValue(x, z))
+			{
+				row[x / kBitsPerWord] |= uint64_t(1) << (x % kBitsPerWord);
+			}
+		}
+	}
+}
+
+bool BitsetCellRegion::CopyTo(SC4CellRegion<int32_t>& region) const
+{
+	const auto& regionBounds = region.bounds;
+
+	if (regionBounds.topLeftX != bounds.topLeftX
+		|| regionBounds.topLeftY != bounds.topLeftY
+		|| regionBounds.bottomRightX != bounds.bottomRightX
+		|| regionBounds.bottomRightY != bounds.bottomRightY)
+	{
+		return false;
+	}
+
+	WriteCells(region.cellMap);
+
+	return true;
+}
+
+const SC4CellRegion<int32_t>& BitsetCellRegion::CopyTo(ReusableCellRegion& target) const
+{
+	if (!target.region || width > target.capacityWidth || height > target.capacityHeight)
+	{
+		// The cell map covers both the previous and the new size, so that selections
+		// that alternate between a wide and a tall shape do not reallocate it each time.
+		target.capacityWidth = std::max(width, target.capacityWidth);
+		target.capacityHeight = std::max(height, target.capacityHeight);
+		target.region.emplace(
+			bounds.topLeftX,
+			bounds.topLeftY,
+			bounds.topLeftX + static_cast<int32_t>(target.capacityWidth) - 1,
+			bounds.topLeftY + static_cast<int32_t>(target.capacityHeight) - 1,
+			false);
+		target.usedWidth = 0;
+		target.usedHeight = 0;
+	}
+
+	SC4CellRegion<int32_t>& region = *target.region;
+
+	region.bounds = bounds;
+	WriteCells(region.cellMap);
+
+	// Clear the cells that the previous conversion wrote outside of the new bounds.
+	for (uint32_t z = 0; z < target.usedHeight; z++)
+	{
+		for (uint32_t x = z < height ? width : 0; x < target.usedWidth; x++)
+		{
+			region.cellMap.SetValue(x, z, false);
+		}
+	}
+
+	target.usedWidth = width;
+	target.usedHeight = height;
+
+	return region;
+}
+
+SC4CellRegion<int32_t> BitsetCellRegion::ToCellRegion() const
+{
+	SC4CellRegion<int32_t> region(bounds.topLeftX, bounds.topLeftY, bounds.bottomRightX, bounds.bottomRightY, false);
+
+	for (uint32_t z = 0; z < height; z++)
+	{
+		const uint64_t* row = GetRow(z);
+
+		for (uint32_t x = 0; x < width; x++)
+		{
+			if ((row[x / kBitsPerWord] >> (x % kBitsPerWord)) & 1)
+			{
+				region.cellMap.SetValue(x, z, true);
+			}
+		}
+	}
+
+	return region;
+}
+
+void BitsetCellRegion::WriteCells(cRZCellMap& cellMap) const
+{
+	for (uint32_t z = 0; z < height; z++)
+	{
+		const uint64_t* row = GetRow(z);
+
+		for (uint32_t x = 0; x < width; x++)
+		{
+			cellMap.SetValue(x, z, (row[x / kBitsPerWord] >> (x % kBitsPerWord)) & 1);
+		}
+	}
+}
+
+bool BitsetCellRegion::HasSameRowLayout(const BitsetCellRegion& other) const
+{
+	return bounds.topLeftX == other.bounds.topLeftX && width == other.width;
+}
+
+void BitsetCellRegion::Combine(const BitsetCellRegion& other, Operation operation)
+{
+	// The rows of this region that overlap the other region.
+	const int32_t firstOverlapRow = std::clamp(other.bounds.topLeftY - bounds.topLeftY, 0, static_cast<int32_t>(height));
+	const int32_t lastOverlapRow = std::clamp(other.bounds.topLeftY + static_cast<int32_t>(other.height) - bounds.topLeftY, 0, static_cast<int32_t>(height));
+
+	if (operation == Operation::Intersect)
+	{
+		const BitsetKernels::KernelTable& kernels = BitsetKernels::GetKernels();
+
+		kernels.fill(words.data(), static_cast<size_t>(firstOverlapRow) * wordsPerRow, 0);
+
+		if (lastOverlapRow < static_cast<int32_t>(height))
+		{
+			kernels.fill(
+				GetRow(static_cast<uint32_t>(lastOverlapRow)),
+				static_cast<size_t>(height - lastOverlapRow) * wordsPerRow,
+				0);
+		}
+	}
+
+	if (firstOverlapRow >= lastOverlapRow)
+	{
+		return;
+	}
+
+	const uint32_t otherFirstRow = static_cast<uint32_t>(bounds.topLeftY + firstOverlapRow - other.bounds.topLeftY);
+
+	if (HasSameRowLayout(other))
+	{
+		// The overlapping rows are contiguous in both regions, so they can be combined
+		// as a single word array.
+		uint64_t* destination = GetRow(static_cast<uint32_t>(firstOverlapRow));
+		const uint64_t* source = other.GetRow(otherFirstRow);
+		const size_t count = static_cast<size_t>(lastOverlapRow - firstOverlapRow) * wordsPerRow;
+
+		const BitsetKernels::KernelTable& kernels = BitsetKernels::GetKernels();
+
+		switch (operation)
+		{
+		case Operation::Unite:
+			kernels.unite(destination, source, count);
+			break;
+		case Operation::Intersect:
+			kernels.intersect(destination, source, count);
+			break;
+		case Operation::Subtract:
+			kernels.subtract(destination, source, count);
+			break;
+		}
+	}
+	else
+	{
+		// The columns do not line up, so the other region's rows are shifted into place a
+		// word at a time.
+		const int64_t columnOffset = static_cast<int64_t>(bounds.topLeftX) - other.bounds.topLeftX;
+		const uint32_t lastWordBits = width % kBitsPerWord;
+		const uint64_t lastWordMask = lastWordBits != 0 ? GetBitMask(0, lastWordBits - 1) : ~uint64_t(0);
+
+		for (int32_t z = firstOverlapRow; z < lastOverlapRow; z++)
+		{
+			uint64_t* row = GetRow(static_cast<uint32_t>(z));
+			const uint64_t* otherRow = other.GetRow(otherFirstRow + static_cast<uint32_t>(z - firstOverlapRow));
+
+			for (uint32_t i = 0; i < wordsPerRow; i++)
+			{
+				uint64_t otherBits = ReadBits(otherRow, other.wordsPerRow, columnOffset + static_cast<int64_t>(i) * kBitsPerWord);
+
+				if ((i + 1) == wordsPerRow)
+				{
+					otherBits &= lastWordMask;
+				}
+
+				switch (operation)
+				{
+				case Operation::Unite:
+					row[i] |= otherBits;
+					break;
+				case Operation::Intersect:
+					row[i] &= otherBits;
+					break;
+				case Operation::Subtract:
+					row[i] &= ~otherBits;
+					break;
+				}
+			}
+		}
+	}
+}
+
+uint64_t* BitsetCellRegion::GetRow(uint32_t z)
+{
+	return words.data() + static_cast<size_t>(z) * wordsPerRow;
+}
+
+const uint64_t* BitsetCellRegion::GetRow(uint32_t z) const
+{
+	return words.data() + static_cast<size_t>(z) * wordsPerRow;
+}
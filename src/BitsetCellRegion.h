@@ -0,0 +1,120 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4CellRegion.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// A game region that is kept between conversions, see BitsetCellRegion::CopyTo.
+// The cell map is sized to the largest bounds so far, the region bounds cover its top left part
+// and the cells outside of the bounds are kept clear.
+struct ReusableCellRegion
+{
+	std::optional<SC4CellRegion<int32_t>> region;
+	uint32_t capacityWidth = 0;
+	uint32_t capacityHeight = 0;
+	// The part of the cell map that the previous conversion wrote.
+	uint32_t usedWidth = 0;
+	uint32_t usedHeight = 0;
+};
+
+// A cell region that stores one bit per cell, packed into 64-bit words.
+// Each row starts on a word boundary, so rows can be combined a word at a time.
+//
+// The selection shapes are built and combined in this form, they are only converted
+// to the game's SC4CellRegion<int32_t> when the region is passed to the game.
+class BitsetCellRegion
+{
+public:
+	BitsetCellRegion();
+	BitsetCellRegion(int32_t minX, int32_t minZ, int32_t maxX, int32_t maxZ);
+	explicit BitsetCellRegion(const SC4CellRegion<int32_t>& region);
+
+	// Changes the region bounds and clears all cells.
+	// The existing storage is reused when it is large enough.
+	void Reset(int32_t minX, int32_t minZ, int32_t maxX, int32_t maxZ);
+
+	const SC4Rect<int32_t>& GetBounds() const;
+	uint32_t GetWidth() const;
+	uint32_t GetHeight() const;
+
+	// The cell coordinates are relative to the top left of the region, matching cRZCellMap.
+	bool GetValue(uint32_t x, uint32_t z) const;
+	void SetValue(uint32_t x, uint32_t z, bool value);
+
+	// Sets the cells in [start, end] of the specified row, the span is clipped to the region.
+	void FillRowSpan(uint32_t z, int32_t start, int32_t end, bool value);
+
+	void Clear();
+
+	// The boolean operations use city coordinates, the cells of other that are outside
+	// of this region are ignored.
+	void CopyFrom(const BitsetCellRegion& other);
+	void Unite(const BitsetCellRegion& other);
+	void Intersect(const BitsetCellRegion& other);
+	void Subtract(const BitsetCellRegion& other);
+
+	// Gets the number of cells that are set.
+	uint64_t PopCount() const;
+	// Gets the number of cells that are set in a row.
+	uint64_t PopCountRow(uint32_t z) const;
+
+	// Gets the bounds of the cells that are set, in city coordinates.
+	// Returns false if no cells are set.
+	bool GetSetCellBounds(SC4Rect<int32_t>& setCellBounds) const;
+
+	// Returns true if any cell within the rectangle is set, the rectangle uses city coordinates
+	// and is clipped to the region.
+	bool HasSetCells(const SC4Rect<int32_t>& rect) const;
+
+	// Conversions to and from the game's region type.
+	void CopyFrom(const SC4CellRegion<int32_t>& region);
+	// Returns false if the region bounds do not match.
+	bool CopyTo(SC4CellRegion<int32_t>& region) const;
+	// Copies the cells to a region that is kept between calls, its cell map is only
+	// reallocated when the bounds are larger than any previous bounds.
+	const SC4CellRegion<int32_t>& CopyTo(ReusableCellRegion& target) const;
+	SC4CellRegion<int32_t> ToCellRegion() const;
+
+private:
+	enum class Operation
+	{
+		Unite,
+		Intersect,
+		Subtract
+	};
+
+	// Writes the cells to the top left of a cell map that is at least as large as the region.
+	void WriteCells(cRZCellMap& cellMap) const;
+	bool HasSameRowLayout(const BitsetCellRegion& other) const;
+	void Combine(const BitsetCellRegion& other, Operation operation);
+
+	uint64_t* GetRow(uint32_t z);
+	const uint64_t* GetRow(uint32_t z) const;
+
+	SC4Rect<int32_t> bounds;
+	uint32_t width;
+	uint32_t height;
+	uint32_t wordsPerRow;
+	std::vector<uint64_t> words;
+};
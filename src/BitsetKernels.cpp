@@ -0,0 +1,171 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BitsetKernels.h"
+#include "BitsetKernelsAvx2.h"
+#include <bit>
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace
+{
+	void FillScalar(uint64_t* destination, size_t count, uint64_t value)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			destination[i] = value;
+		}
+	}
+
+	void CopyScalar(uint64_t* destination, const uint64_t* source, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			destination[i] = source[i];
+		}
+	}
+
+	void UniteScalar(uint64_t* destination, const uint64_t* source, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			destination[i] |= source[i];
+		}
+	}
+
+	void IntersectScalar(uint64_t* destination, const uint64_t* source, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			destination[i] &= source[i];
+		}
+	}
+
+	void SubtractScalar(uint64_t* destination, const uint64_t* source, size_t count)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			destination[i] &= ~source[i];
+		}
+	}
+
+	uint64_t PopCountScalar(const uint64_t* source, size_t count)
+	{
+		uint64_t total = 0;
+
+		for (size_t i = 0; i < count; i++)
+		{
+			total += static_cast<uint64_t>(std::popcount(source[i]));
+		}
+
+		return total;
+	}
+
+	constexpr BitsetKernels::KernelTable ScalarKernels
+	{
+		&FillScalar,
+		&CopyScalar,
+		&UniteScalar,
+		&IntersectScalar,
+		&SubtractScalar,
+		&PopCountScalar,
+	};
+
+#ifdef BITSET_KERNELS_AVX2_SUPPORTED
+	constexpr BitsetKernels::KernelTable Avx2Kernels
+	{
+		&BitsetKernelsAvx2::Fill,
+		&BitsetKernelsAvx2::Copy,
+		&BitsetKernelsAvx2::Unite,
+		&BitsetKernelsAvx2::Intersect,
+		&BitsetKernelsAvx2::Subtract,
+		&BitsetKernelsAvx2::PopCount,
+	};
+
+	bool IsAvx2SupportedCore()
+	{
+#if defined(_MSC_VER) && !defined(__clang__)
+		int cpuInfo[4]{};
+
+		__cpuid(cpuInfo, 0);
+
+		if (cpuInfo[0] < 7)
+		{
+			return false;
+		}
+
+		__cpuid(cpuInfo, 1);
+
+		constexpr int kOSXSaveBit = 1 << 27;
+		constexpr int kAVXBit = 1 << 28;
+
+		if ((cpuInfo[2] & (kOSXSaveBit | kAVXBit)) != (kOSXSaveBit | kAVXBit))
+		{
+			return false;
+		}
+
+		// Check that the OS saves the YMM registers.
+		if ((_xgetbv(0) & 0x6) != 0x6)
+		{
+			return false;
+		}
+
+		__cpuidex(cpuInfo, 7, 0);
+
+		constexpr int kAVX2Bit = 1 << 5;
+
+		return (cpuInfo[1] & kAVX2Bit) != 0;
+#else
+		return __builtin_cpu_supports("avx2");
+#endif
+	}
+
+	bool IsAvx2Supported()
+	{
+		static const bool supported = IsAvx2SupportedCore();
+
+		return supported;
+	}
+#endif // BITSET_KERNELS_AVX2_SUPPORTED
+}
+
+const BitsetKernels::KernelTable& BitsetKernels::GetKernels()
+{
+	static const KernelTable& kernels = GetAvx2Kernels() ? *GetAvx2Kernels() : ScalarKernels;
+
+	return kernels;
+}
+
+const BitsetKernels::KernelTable& BitsetKernels::GetScalarKernels()
+{
+	return ScalarKernels;
+}
+
+const BitsetKernels::KernelTable* BitsetKernels::GetAvx2Kernels()
+{
+#ifdef BITSET_KERNELS_AVX2_SUPPORTED
+	return IsAvx2Supported() ? &Avx2Kernels : nullptr;
+#else
+	return nullptr;
+#endif // BITSET_KERNELS_AVX2_SUPPORTED
+}
@@ -0,0 +1,48 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Word array operations used by BitsetCellRegion.
+// An AVX2 implementation is selected at runtime when the CPU and OS support it,
+// otherwise the portable scalar implementation is used.
+namespace BitsetKernels
+{
+	struct KernelTable
+	{
+		void (*fill)(uint64_t* destination, size_t count, uint64_t value);
+		void (*copy)(uint64_t* destination, const uint64_t* source, size_t count);
+		void (*unite)(uint64_t* destination, const uint64_t* source, size_t count);
+		void (*intersect)(uint64_t* destination, const uint64_t* source, size_t count);
+		void (*subtract)(uint64_t* destination, const uint64_t* source, size_t count);
+		uint64_t (*popCount)(const uint64_t* source, size_t count);
+	};
+
+	// Gets the fastest implementation that the current CPU supports.
+	const KernelTable& GetKernels();
+
+	const KernelTable& GetScalarKernels();
+
+	// Returns nullptr if the AVX2 implementation is not available.
+	const KernelTable* GetAvx2Kernels();
+}
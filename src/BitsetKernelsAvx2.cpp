@@ -0,0 +1,181 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "BitsetKernelsAvx2.h"
+
+#ifdef BITSET_KERNELS_AVX2_SUPPORTED
+#include <bit>
+#include <immintrin.h>
+
+// MSVC allows the AVX2 intrinsics to be used without enabling AVX2 for the whole
+// project, GCC and Clang require the functions to be marked with the target ISA.
+#if defined(__GNUC__) || defined(__clang__)
+#define AVX2_FUNCTION __attribute__((target("avx2")))
+#else
+#define AVX2_FUNCTION
+#endif
+
+namespace
+{
+	constexpr size_t kWordsPerVector = sizeof(__m256i) / sizeof(uint64_t);
+
+	enum class Operation
+	{
+		Copy,
+		Unite,
+		Intersect,
+		Subtract
+	};
+
+	template <Operation operation>
+	AVX2_FUNCTION inline void ApplyBinaryOp(uint64_t* destination, const uint64_t* source, size_t count)
+	{
+		size_t i = 0;
+
+		for (; i + kWordsPerVector <= count; i += kWordsPerVector)
+		{
+			__m256i* pDestination = reinterpret_cast<__m256i*>(destination + i);
+
+			const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+
+			if constexpr (operation == Operation::Copy)
+			{
+				_mm256_storeu_si256(pDestination, b);
+			}
+			else
+			{
+				const __m256i a = _mm256_loadu_si256(pDestination);
+
+				if constexpr (operation == Operation::Unite)
+				{
+					_mm256_storeu_si256(pDestination, _mm256_or_si256(a, b));
+				}
+				else if constexpr (operation == Operation::Intersect)
+				{
+					_mm256_storeu_si256(pDestination, _mm256_and_si256(a, b));
+				}
+				else
+				{
+					// _mm256_andnot_si256 computes ~first & second.
+					_mm256_storeu_si256(pDestination, _mm256_andnot_si256(b, a));
+				}
+			}
+		}
+
+		for (; i < count; i++)
+		{
+			if constexpr (operation == Operation::Copy)
+			{
+				destination[i] = source[i];
+			}
+			else if constexpr (operation == Operation::Unite)
+			{
+				destination[i] |= source[i];
+			}
+			else if constexpr (operation == Operation::Intersect)
+			{
+				destination[i] &= source[i];
+			}
+			else
+			{
+				destination[i] &= ~source[i];
+			}
+		}
+	}
+}
+
+AVX2_FUNCTION void BitsetKernelsAvx2::Fill(uint64_t* destination, size_t count, uint64_t value)
+{
+	const __m256i vector = _mm256_set1_epi64x(static_cast<long long>(value));
+
+	size_t i = 0;
+
+	for (; i + kWordsPerVector <= count; i += kWordsPerVector)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + i), vector);
+	}
+
+	for (; i < count; i++)
+	{
+		destination[i] = value;
+	}
+}
+
+AVX2_FUNCTION void BitsetKernelsAvx2::Copy(uint64_t* destination, const uint64_t* source, size_t count)
+{
+	ApplyBinaryOp<Operation::Copy>(destination, source, count);
+}
+
+AVX2_FUNCTION void BitsetKernelsAvx2::Unite(uint64_t* destination, const uint64_t* source, size_t count)
+{
+	ApplyBinaryOp<Operation::Unite>(destination, source, count);
+}
+
+AVX2_FUNCTION void BitsetKernelsAvx2::Intersect(uint64_t* destination, const uint64_t* source, size_t count)
+{
+	ApplyBinaryOp<Operation::Intersect>(destination, source, count);
+}
+
+AVX2_FUNCTION void BitsetKernelsAvx2::Subtract(uint64_t* destination, const uint64_t* source, size_t count)
+{
+	ApplyBinaryOp<Operation::Subtract>(destination, source, count);
+}
+
+AVX2_FUNCTION uint64_t BitsetKernelsAvx2::PopCount(const uint64_t* source, size_t count)
+{
+	// Counts the bits in each nibble with a 16 entry lookup table, the byte counts
+	// are then summed into 64-bit lanes with _mm256_sad_epu8.
+	const __m256i lookup = _mm256_setr_epi8(
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+		0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+	const __m256i lowNibbleMask = _mm256_set1_epi8(0x0F);
+
+	__m256i totals = _mm256_setzero_si256();
+
+	size_t i = 0;
+
+	for (; i + kWordsPerVector <= count; i += kWordsPerVector)
+	{
+		const __m256i vector = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+
+		const __m256i lowNibbles = _mm256_and_si256(vector, lowNibbleMask);
+		const __m256i highNibbles = _mm256_and_si256(_mm256_srli_epi16(vector, 4), lowNibbleMask);
+
+		const __m256i byteCounts = _mm256_add_epi8(
+			_mm256_shuffle_epi8(lookup, lowNibbles),
+			_mm256_shuffle_epi8(lookup, highNibbles));
+
+		totals = _mm256_add_epi64(totals, _mm256_sad_epu8(byteCounts, _mm256_setzero_si256()));
+	}
+
+	alignas(32) uint64_t laneTotals[kWordsPerVector];
+	_mm256_store_si256(reinterpret_cast<__m256i*>(laneTotals), totals);
+
+	uint64_t total = laneTotals[0] + laneTotals[1] + laneTotals[2] + laneTotals[3];
+
+	for (; i < count; i++)
+	{
+		total += static_cast<uint64_t>(std::popcount(source[i]));
+	}
+
+	return total;
+}
+#endif // BITSET_KERNELS_AVX2_SUPPORTED
@@ -0,0 +1,40 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_M_IX86) || defined(_M_X64) || defined(__i386__) || defined(__x86_64__)
+#define BITSET_KERNELS_AVX2_SUPPORTED
+
+// The AVX2 implementations of the BitsetKernels functions.
+// These must only be called when the CPU supports AVX2, see BitsetKernels::GetKernels.
+namespace BitsetKernelsAvx2
+{
+	void Fill(uint64_t* destination, size_t count, uint64_t value);
+	void Copy(uint64_t* destination, const uint64_t* source, size_t count);
+	void Unite(uint64_t* destination, const uint64_t* source, size_t count);
+	void Intersect(uint64_t* destination, const uint64_t* source, size_t count);
+	void Subtract(uint64_t* destination, const uint64_t* source, size_t count);
+	uint64_t PopCount(const uint64_t* source, size_t count);
+}
+#endif
@@ -26,6 +26,8 @@
 #include "FileSystem.h"
 #include "GlobalCityPointers.h"
 #include "Logger.h"
+#include "CityOccupantIndex.h"
+#include "OccupantFilterExpressions.h"
 #include "cIGZApp.h"
 #include "cIGZCheatCodeManager.h"
 #include "cIGZCOM.h"
@@ -38,6 +40,7 @@
 #include "cIGZWinKeyAcceleratorRes.h"
 #include "cISC4App.h"
 #include "cISC4City.h"
+#include "cISC4Occupant.h"
 #include "cISC4View3DWin.h"
 #include "cISC4ViewInputControl.h"
 #include "cRZAutoRefCount.h"
@@ -50,6 +53,8 @@ static constexpr uint32_t kBulldozeExtensionsDirectorID = 0x5B7D9E30;
 static constexpr uint32_t kSC4MessagePostCityInit = 0x26D31EC1;
 static constexpr uint32_t kSC4MessagePreCityShutdown = 0x26D31EC2;
 static constexpr uint32_t kSC4MessageCityEstablished = 0x26D31EC4;
+static constexpr uint32_t kSC4MessageInsertOccupant = 0x99EF1142;
+static constexpr uint32_t kSC4MessageRemoveOccupant = 0x99EF1143;
 
 static constexpr uint32_t BulldozeDiagonalShortcutID = 0x6A935D37;
 static constexpr uint32_t BulldozeFloraShortcutID = 0x755C6E40;
@@ -60,14 +65,18 @@ static constexpr uint32_t DezoneKeepNetworksShortcutID = 0x0AFB2546;
 
 IBulldozeHighlightColors* spBulldozeHighlightColors = nullptr;
 cISC4LotManager* spLotManager = nullptr;
+ICityOccupantIndex* spCityOccupantIndex = nullptr;
+IOccupantFilterExpressions* spOccupantFilterExpressions = nullptr;
 
 class BulldozeExtensionsDllDirector final : public cRZMessage2COMDirector
 {
 public:
 	BulldozeExtensionsDllDirector()
-		: bulldozeHighlightColors(), pView3D(nullptr)
+		: bulldozeHighlightColors(), cityOccupantIndex(), occupantFilterExpressions(), pView3D(nullptr)
 	{
 		spBulldozeHighlightColors = &bulldozeHighlightColors;
+		spCityOccupantIndex = &cityOccupantIndex;
+		spOccupantFilterExpressions = &occupantFilterExpressions;
 
 		Logger& logger = Logger::GetInstance();
 		logger.Init(FileSystem::GetLogFilePath(), LogLevel::Info);
@@ -137,6 +146,17 @@ private:
 		}
 	}
 
+	void UnregisterOccupantNotifications()
+	{
+		cIGZMessageServer2Ptr pMS2;
+
+		if (pMS2)
+		{
+			pMS2->RemoveNotification(this, kSC4MessageInsertOccupant);
+			pMS2->RemoveNotification(this, kSC4MessageRemoveOccupant);
+		}
+	}
+
 	void CityEstablished()
 	{
 		cIGZMessageServer2Ptr pMS2;
@@ -178,6 +198,10 @@ private:
 						if (pCity)
 						{
 							spLotManager = pCity->GetLotManager();
+							cityOccupantIndex.Init(pCity);
+
+							pMS2->AddNotification(this, kSC4MessageInsertOccupant);
+							pMS2->AddNotification(this, kSC4MessageRemoveOccupant);
 
 							if (pCity->GetEstablished())
 							{
@@ -193,12 +217,17 @@ private:
 			}
 		}
 		bulldozeHighlightColors.Init();
+		occupantFilterExpressions.Init();
 	}
 
 	void PreCityShutdown()
 	{
+		cSC4ViewInputControlDemolishHooks::CityShutdown();
 		UnregisterBulldozeShortcutNotifications();
+		UnregisterOccupantNotifications();
 		bulldozeHighlightColors.Shutdown();
+		occupantFilterExpressions.Shutdown();
+		cityOccupantIndex.Shutdown();
 		spLotManager = nullptr;
 
 		cISC4View3DWin* localView3D = pView3D;
@@ -223,6 +252,18 @@ private:
 		case kSC4MessagePreCityShutdown:
 			PreCityShutdown();
 			break;
+		case kSC4MessageInsertOccupant:
+			cityOccupantIndex.OccupantInserted(static_cast<cISC4Occupant*>(static_cast<cIGZMessage2Standard*>(pMsg)->GetVoid1()));
+			cSC4ViewInputControlDemolishHooks::OccupantInserted();
+			break;
+		case kSC4MessageRemoveOccupant:
+		{
+			cISC4Occupant* pOccupant = static_cast<cISC4Occupant*>(static_cast<cIGZMessage2Standard*>(pMsg)->GetVoid1());
+
+			cityOccupantIndex.OccupantRemoved(pOccupant);
+			cSC4ViewInputControlDemolishHooks::OccupantRemoved(pOccupant);
+			break;
+		}
 		case BulldozeDiagonalShortcutID:
 			ActivateBulldozeTool(cSC4ViewInputControlDemolishHooks::BulldozeCursorDefaultDiagonal);
 			break;
@@ -275,6 +316,8 @@ private:
 
 	cISC4View3DWin* pView3D;
 	BulldozeHighlightColors bulldozeHighlightColors;
+	CityOccupantIndex cityOccupantIndex;
+	OccupantFilterExpressions occupantFilterExpressions;
 };
 
 cRZCOMDllDirector* RZGetCOMDllDirector() {
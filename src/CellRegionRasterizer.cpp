@@ -0,0 +1,878 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CellRegionRasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <utility>
+
+namespace
+{
+	struct DiagonalEndpoints
+	{
+		int32_t startX;
+		int32_t startZ;
+		int32_t endX;
+		int32_t endZ;
+	};
+
+	DiagonalEndpoints GetDiagonalEndpoints(
+		int32_t minX,
+		int32_t minZ,
+		int32_t maxX,
+		int32_t maxZ,
+		int32_t startX,
+		int32_t startZ)
+	{
+		DiagonalEndpoints endpoints{};
+
+		// Determine diagonal direction based on click position relative to bounding box
+		if (startX != -1 && startZ != -1)
+		{
+			// Use the reliable click coordinates to determine diagonal direction
+			// Simply draw from the click point to the opposite corner
+			int32_t centerX = (minX + maxX) / 2;
+			int32_t centerZ = (minZ + maxZ) / 2;
+
+			if (startX <= centerX && startZ <= centerZ)
+			{
+				// Click in northwest area -> draw NW to SE
+				endpoints = { minX, minZ, maxX, maxZ };
+			}
+			else if (startX > centerX && startZ <= centerZ)
+			{
+				// Click in northeast area -> draw NE to SW
+				endpoints = { maxX, minZ, minX, maxZ };
+			}
+			else if (startX <= centerX && startZ > centerZ)
+			{
+				// Click in southwest area -> draw SW to NE
+				endpoints = { minX, maxZ, maxX, minZ };
+			}
+			else
+			{
+				// Click in southeast area -> draw SE to NW
+				endpoints = { maxX, maxZ, minX, minZ };
+			}
+		}
+		else
+		{
+			// No start point provided - use default NW-to-SE diagonal
+			endpoints = { minX, minZ, maxX, maxZ };
+		}
+
+		return endpoints;
+	}
+
+	bool GetRegionSize(const SC4CellRegion<int32_t>& region, uint32_t& width, uint32_t& height)
+	{
+		const auto& bounds = region.bounds;
+
+		if (bounds.topLeftX > bounds.bottomRightX || bounds.topLeftY > bounds.bottomRightY)
+		{
+			return false;
+		}
+
+		width = static_cast<uint32_t>(bounds.bottomRightX - bounds.topLeftX + 1);
+		height = static_cast<uint32_t>(bounds.bottomRightY - bounds.topLeftY + 1);
+
+		return true;
+	}
+
+	// A polygon edge in the scanline fill edge table.
+	// The edge's x position on the current row is xNumerator / dz, the fraction is kept exact
+	// by stepping the numerator by dx for each row.
+	struct PolygonEdge
+	{
+		int32_t minZ;
+		int32_t maxZ;
+		int64_t xNumerator;
+		int32_t dx;
+		int32_t dz;
+	};
+
+	int64_t FloorDivide(int64_t numerator, int64_t denominator)
+	{
+		int64_t quotient = numerator / denominator;
+
+		if ((numerator % denominator) != 0 && numerator < 0)
+		{
+			quotient--;
+		}
+
+		return quotient;
+	}
+
+	int64_t CeilDivide(int64_t numerator, int64_t denominator)
+	{
+		return -FloorDivide(-numerator, denominator);
+	}
+
+	// Gets the number of cells along the minor axis that a line of the specified width covers.
+	int32_t GetMinorAxisExtent(int32_t width, int32_t majorDelta, int32_t minorDelta)
+	{
+		if (majorDelta == 0)
+		{
+			return width;
+		}
+
+		const double length = std::sqrt(static_cast<double>(majorDelta) * majorDelta + static_cast<double>(minorDelta) * minorDelta);
+
+		return (std::max)(width, static_cast<int32_t>(std::lround(width * length / majorDelta)));
+	}
+
+	bool IsEdgeLeftOf(const PolygonEdge& a, const PolygonEdge& b)
+	{
+		// Compares a.xNumerator / a.dz < b.xNumerator / b.dz, both denominators are positive.
+		return a.xNumerator * b.dz < b.xNumerator * a.dz;
+	}
+
+	void DrawLine(BitsetCellRegion& region, CellRegionRasterizer::CellPoint start, CellRegionRasterizer::CellPoint end)
+	{
+		const auto& bounds = region.GetBounds();
+
+		const int32_t dx = abs(end.x - start.x);
+		const int32_t dz = abs(end.z - start.z);
+		const int32_t sx = start.x < end.x ? 1 : -1;
+		const int32_t sz = start.z < end.z ? 1 : -1;
+		int32_t err = dx - dz;
+
+		int32_t x = start.x;
+		int32_t z = start.z;
+
+		while (true)
+		{
+			region.SetValue(
+				static_cast<uint32_t>(x - bounds.topLeftX),
+				static_cast<uint32_t>(z - bounds.topLeftY),
+				true);
+
+			if (x == end.x && z == end.z)
+			{
+				break;
+			}
+
+			int32_t e2 = 2 * err;
+
+			if (e2 > -dz)
+			{
+				err -= dz;
+				x += sx;
+			}
+			if (e2 < dx)
+			{
+				err += dx;
+				z += sz;
+			}
+		}
+	}
+}
+
+SC4CellRegion<int32_t> CellRegionRasterizer::CreateDiagonalRegion(
+	int32_t x1,
+	int32_t z1,
+	int32_t x2,
+	int32_t z2,
+	int32_t thickness,
+	int32_t startX,
+	int32_t startZ)
+{
+	// Create region with all cells initially false
+	SC4CellRegion<int32_t> region(
+		(std::min)(x1, x2),
+		(std::min)(z1, z2),
+		(std::max)(x1, x2),
+		(std::max)(z1, z2),
+		false);
+
+	std::vector<RowSpan> spans;
+	GetDiagonalSpans(x1, z1, x2, z2, thickness, startX, startZ, spans);
+
+	for (size_t z = 0; z < spans.size(); z++)
+	{
+		FillRowSpan(region.cellMap, static_cast<uint32_t>(z), spans[z].start, spans[z].end, true);
+	}
+
+	return region;
+}
+
+bool CellRegionRasterizer::RasterizeDiagonal(
+	SC4CellRegion<int32_t>& region,
+	int32_t thickness,
+	int32_t startX,
+	int32_t startZ)
+{
+	const auto& bounds = region.bounds;
+
+	if (bounds.topLeftX > bounds.bottomRightX || bounds.topLeftY > bounds.bottomRightY)
+	{
+		return false;
+	}
+
+	std::vector<RowSpan> spans;
+	GetDiagonalSpans(
+		bounds.topLeftX,
+		bounds.topLeftY,
+		bounds.bottomRightX,
+		bounds.bottomRightY,
+		thickness,
+		startX,
+		startZ,
+		spans);
+
+	return FillRegion(region, spans);
+}
+
+void CellRegionRasterizer::GetDiagonalSpans(
+	int32_t x1,
+	int32_t z1,
+	int32_t x2,
+	int32_t z2,
+	int32_t thickness,
+	int32_t startX,
+	int32_t startZ,
+	std::vector<RowSpan>& spans)
+{
+	// Calculate bounding box for the region
+	const int32_t minX = (std::min)(x1, x2);
+	const int32_t maxX = (std::max)(x1, x2);
+	const int32_t minZ = (std::min)(z1, z2);
+	const int32_t maxZ = (std::max)(z1, z2);
+
+	const int32_t width = maxX - minX + 1;
+	const int32_t height = maxZ - minZ + 1;
+
+	spans.assign(static_cast<size_t>(height), RowSpan{ 0, -1 });
+
+	const DiagonalEndpoints diagonal = GetDiagonalEndpoints(minX, minZ, maxX, maxZ, startX, startZ);
+
+	// The perpendicular offsets covered by the line thickness.
+	// Handle positive/negative thickness values (skip 0)
+	int32_t startOffset, endOffset;
+
+	if (thickness > 0)
+	{
+		startOffset = 0;
+		endOffset = thickness - 1;
+	}
+	else
+	{
+		startOffset = thickness + 1;
+		endOffset = 0;
+	}
+
+	// Use Bresenham's line algorithm to find the line cells, the line covers every
+	// row and column of the bounding box.
+	const int32_t dx = abs(diagonal.endX - diagonal.startX);
+	const int32_t dz = abs(diagonal.endZ - diagonal.startZ);
+	const int32_t sx = diagonal.startX < diagonal.endX ? 1 : -1;
+	const int32_t sz = diagonal.startZ < diagonal.endZ ? 1 : -1;
+	int32_t err = dx - dz;
+
+	int32_t currentX = diagonal.startX - minX;
+	int32_t currentZ = diagonal.startZ - minZ;
+	const int32_t endX = diagonal.endX - minX;
+	const int32_t endZ = diagonal.endZ - minZ;
+
+	const bool moreHorizontal = dx > dz;
+
+	while (true)
+	{
+		RowSpan& span = spans[currentZ];
+
+		if (moreHorizontal)
+		{
+			// Record the extent of the line in this row, the thickness is added below.
+			if (span.IsEmpty())
+			{
+				span = { currentX, currentX };
+			}
+			else
+			{
+				span.start = (std::min)(span.start, currentX);
+				span.end = (std::max)(span.end, currentX);
+			}
+		}
+		else
+		{
+			// More vertical line - the line moves to a new row on every step, so the
+			// thickness is added horizontally to the single cell in this row.
+			span.start = (std::max)(currentX + startOffset, 0);
+			span.end = (std::min)(currentX + endOffset, width - 1);
+		}
+
+		if (currentX == endX && currentZ == endZ)
+		{
+			break;
+		}
+
+		int32_t e2 = 2 * err;
+
+		if (e2 > -dz)
+		{
+			err -= dz;
+			currentX += sx;
+		}
+		if (e2 < dx)
+		{
+			err += dx;
+			currentZ += sz;
+		}
+	}
+
+	if (moreHorizontal && (startOffset != 0 || endOffset != 0))
+	{
+		// More horizontal line - the thickness is added vertically, so each row is covered
+		// by the line cells of the rows in [row - endOffset, row - startOffset].
+		// The line's row extents are adjacent and move in one direction, so the union of
+		// that window only depends on the rows at either end of it.
+		// The rows are updated in place, in the order that keeps the rows which are still
+		// needed by the remaining rows unmodified.
+		const auto getWindowSpan = [&](int32_t row)
+		{
+			const RowSpan& first = spans[(std::max)(row - endOffset, 0)];
+			const RowSpan& last = spans[(std::min)(row - startOffset, height - 1)];
+
+			return RowSpan{ (std::min)(first.start, last.start), (std::max)(first.end, last.end) };
+		};
+
+		if (startOffset == 0)
+		{
+			for (int32_t row = height - 1; row >= 0; row--)
+			{
+				spans[row] = getWindowSpan(row);
+			}
+		}
+		else
+		{
+			for (int32_t row = 0; row < height; row++)
+			{
+				spans[row] = getWindowSpan(row);
+			}
+		}
+	}
+}
+
+bool CellRegionRasterizer::FillRegion(SC4CellRegion<int32_t>& region, const std::vector<RowSpan>& spans)
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+
+	if (!GetRegionSize(region, width, height) || spans.size() != height)
+	{
+		return false;
+	}
+
+	const int32_t lastColumn = static_cast<int32_t>(width) - 1;
+
+	for (uint32_t z = 0; z < height; z++)
+	{
+		const RowSpan& span = spans[z];
+
+		if (span.IsEmpty())
+		{
+			FillRowSpan(region.cellMap, z, 0, lastColumn, false);
+		}
+		else
+		{
+			FillRowSpan(region.cellMap, z, 0, span.start - 1, false);
+			FillRowSpan(region.cellMap, z, span.start, span.end, true);
+			FillRowSpan(region.cellMap, z, span.end + 1, lastColumn, false);
+		}
+	}
+
+	return true;
+}
+
+void CellRegionRasterizer::GetEllipseSpans(int32_t width, int32_t height, std::vector<RowSpan>& spans)
+{
+	if (width <= 0 || height <= 0)
+	{
+		spans.clear();
+		return;
+	}
+
+	// The quadrant is generated for an ellipse centered on a cell, when a dimension is even
+	// the two halves are moved apart by one cell so that the ellipse fills the bounding box.
+	const int32_t radiusX = (width - 1) / 2;
+	const int32_t radiusZ = (height - 1) / 2;
+	const int32_t extraX = (width % 2) == 0 ? 1 : 0;
+	const int32_t extraZ = (height % 2) == 0 ? 1 : 0;
+
+	// The half widths of the quadrant rows are stored in the end member of the bottom half
+	// rows, indexed by the distance from the center row.
+	spans.assign(static_cast<size_t>(height), RowSpan{ 0, -1 });
+	const std::vector<RowSpan>::iterator halfWidths = spans.begin() + (radiusZ + extraZ);
+
+	for (int32_t z = 0; z <= radiusZ; z++)
+	{
+		halfWidths[z].end = 0;
+	}
+
+	if (radiusZ > 0)
+	{
+		// The midpoint ellipse algorithm, the decision variables are scaled by 4 to keep
+		// them in integer arithmetic.
+		const int64_t rx2 = static_cast<int64_t>(radiusX) * radiusX;
+		const int64_t rz2 = static_cast<int64_t>(radiusZ) * radiusZ;
+
+		int64_t x = 0;
+		int64_t z = radiusZ;
+		int64_t dx = 0;
+		int64_t dz = 2 * rx2 * z;
+
+		const auto record = [&]()
+		{
+			RowSpan& row = halfWidths[static_cast<size_t>(z)];
+			row.end = (std::max)(row.end, static_cast<int32_t>(x));
+		};
+
+		// Region 1, the outline moves more horizontally than vertically.
+		int64_t d1 = (4 * rz2) - (4 * rx2 * radiusZ) + rx2;
+
+		while (dx < dz)
+		{
+			record();
+
+			x++;
+			dx += 2 * rz2;
+
+			if (d1 < 0)
+			{
+				d1 += 4 * (dx + rz2);
+			}
+			else
+			{
+				z--;
+				dz -= 2 * rx2;
+				d1 += 4 * (dx - dz + rz2);
+			}
+		}
+
+		// Region 2, the outline moves more vertically than horizontally.
+		int64_t d2 = (rz2 * (2 * x + 1) * (2 * x + 1)) + (4 * rx2 * (z - 1) * (z - 1)) - (4 * rx2 * rz2);
+
+		while (z >= 0)
+		{
+			record();
+
+			z--;
+			dz -= 2 * rx2;
+
+			if (d2 > 0)
+			{
+				d2 += 4 * (rx2 - dz);
+			}
+			else
+			{
+				x++;
+				dx += 2 * rz2;
+				d2 += 4 * (dx - dz + rx2);
+			}
+		}
+	}
+
+	// The algorithm can stop short of the last cells of the center row for very flat
+	// ellipses, the center row always spans the full width.
+	halfWidths[0].end = radiusX;
+
+	// Mirror the quadrant into the top and bottom halves.
+	for (int32_t z = 0; z <= radiusZ; z++)
+	{
+		const int32_t halfWidth = halfWidths[z].end;
+		const RowSpan span{ radiusX - halfWidth, radiusX + extraX + halfWidth };
+
+		halfWidths[z] = span;
+		spans[static_cast<size_t>(radiusZ - z)] = span;
+	}
+}
+
+void CellRegionRasterizer::RasterizeEllipse(int32_t minX, int32_t minZ, int32_t maxX, int32_t maxZ, BitsetCellRegion& region)
+{
+	region.Reset(minX, minZ, maxX, maxZ);
+
+	std::vector<RowSpan> spans;
+	GetEllipseSpans(maxX - minX + 1, maxZ - minZ + 1, spans);
+
+	for (size_t z = 0; z < spans.size(); z++)
+	{
+		region.FillRowSpan(static_cast<uint32_t>(z), spans[z].start, spans[z].end, true);
+	}
+}
+
+void CellRegionRasterizer::GetLineSpans(
+	const CellPoint& start,
+	const CellPoint& end,
+	int32_t width,
+	SC4Rect<int32_t>& bounds,
+	std::vector<RowSpan>& spans)
+{
+	constexpr int32_t kFixedShift = 16;
+	constexpr int64_t kFixedHalf = int64_t(1) << (kFixedShift - 1);
+
+	width = (std::max)(width, 1);
+
+	const int32_t dx = end.x - start.x;
+	const int32_t dz = end.z - start.z;
+	const int32_t absDx = abs(dx);
+	const int32_t absDz = abs(dz);
+
+	if (absDx >= absDz)
+	{
+		// More horizontal line - step along the columns and add the width vertically.
+		const int32_t extent = GetMinorAxisExtent(width, absDx, absDz);
+		const int32_t below = (extent - 1) / 2;
+		const int32_t above = extent - 1 - below;
+
+		const int32_t minX = (std::min)(start.x, end.x);
+		const int32_t maxX = (std::max)(start.x, end.x);
+		const int32_t centerMinZ = (std::min)(start.z, end.z);
+		const int32_t centerMaxZ = (std::max)(start.z, end.z);
+		const int32_t centerRows = centerMaxZ - centerMinZ + 1;
+
+		bounds = SC4Rect<int32_t>{ minX, centerMinZ - above, maxX, centerMaxZ + below };
+
+		const int32_t height = bounds.bottomRightY - bounds.topLeftY + 1;
+
+		// The center line's extent in each row is stored in the last centerRows rows, so that
+		// the window union below reads them before they are overwritten.
+		spans.assign(static_cast<size_t>(height), RowSpan{ 0, -1 });
+		const std::vector<RowSpan>::iterator centerSpans = spans.begin() + (above + below);
+
+		const int32_t sx = dx >= 0 ? 1 : -1;
+		const int64_t step = absDx > 0 ? (static_cast<int64_t>(dz) << kFixedShift) / absDx : 0;
+		int64_t z = (static_cast<int64_t>(start.z) << kFixedShift) + kFixedHalf;
+		int32_t x = start.x;
+
+		for (int32_t i = 0; i <= absDx; i++)
+		{
+			const int32_t row = static_cast<int32_t>(z >> kFixedShift) - centerMinZ;
+			const int32_t column = x - minX;
+
+			RowSpan& span = centerSpans[(std::clamp)(row, 0, centerRows - 1)];
+
+			if (span.IsEmpty())
+			{
+				span = { column, column };
+			}
+			else
+			{
+				span.start = (std::min)(span.start, column);
+				span.end = (std::max)(span.end, column);
+			}
+
+			x += sx;
+			z += step;
+		}
+
+		if (extent > 1)
+		{
+			// Each row is covered by the center line cells of the rows in [row - below, row + above].
+			// The center line's row extents are adjacent and move in one direction, so the union
+			// of that window only depends on the rows at either end of it.
+			// The rows are written from the top down, the output row is always at or above
+			// the storage of the first center row of its window.
+			for (int32_t row = 0; row < height; row++)
+			{
+				const int32_t first = (std::max)(row - above - below, 0);
+				const int32_t last = (std::min)(row, centerRows - 1);
+
+				if (first > last)
+				{
+					spans[row] = RowSpan{ 0, -1 };
+				}
+				else
+				{
+					const RowSpan firstSpan = centerSpans[first];
+					const RowSpan lastSpan = centerSpans[last];
+
+					spans[row] = RowSpan{ (std::min)(firstSpan.start, lastSpan.start), (std::max)(firstSpan.end, lastSpan.end) };
+				}
+			}
+		}
+	}
+	else
+	{
+		// More vertical line - step along the rows and add the width horizontally.
+		const int32_t extent = GetMinorAxisExtent(width, absDz, absDx);
+		const int32_t left = (extent - 1) / 2;
+		const int32_t right = extent - 1 - left;
+
+		const int32_t minZ = (std::min)(start.z, end.z);
+		const int32_t maxZ = (std::max)(start.z, end.z);
+
+		bounds = SC4Rect<int32_t>
+		{
+			(std::min)(start.x, end.x) - left,
+			minZ,
+			(std::max)(start.x, end.x) + right,
+			maxZ
+		};
+
+		spans.resize(static_cast<size_t>(maxZ - minZ + 1));
+
+		const int32_t sz = dz >= 0 ? 1 : -1;
+		const int64_t step = (static_cast<int64_t>(dx) << kFixedShift) / absDz;
+		int64_t x = (static_cast<int64_t>(start.x) << kFixedShift) + kFixedHalf;
+		int32_t z = start.z;
+
+		for (int32_t i = 0; i <= absDz; i++)
+		{
+			const int32_t column = static_cast<int32_t>(x >> kFixedShift) - bounds.topLeftX;
+
+			spans[static_cast<size_t>(z - minZ)] = RowSpan{ column - left, column + right };
+
+			z += sz;
+			x += step;
+		}
+	}
+}
+
+void CellRegionRasterizer::RasterizeLine(const CellPoint& start, const CellPoint& end, int32_t width, BitsetCellRegion& region)
+{
+	SC4Rect<int32_t> bounds{};
+	std::vector<RowSpan> spans;
+
+	GetLineSpans(start, end, width, bounds, spans);
+
+	region.Reset(bounds.topLeftX, bounds.topLeftY, bounds.bottomRightX, bounds.bottomRightY);
+
+	for (size_t z = 0; z < spans.size(); z++)
+	{
+		region.FillRowSpan(static_cast<uint32_t>(z), spans[z].start, spans[z].end, true);
+	}
+}
+
+void CellRegionRasterizer::RasterizePolyline(const std::vector<CellPoint>& vertices, int32_t width, BitsetCellRegion& region)
+{
+	if (vertices.size() <= 1)
+	{
+		if (vertices.empty())
+		{
+			region.Reset(0, 0, -1, -1);
+		}
+		else
+		{
+			RasterizeLine(vertices[0], vertices[0], width, region);
+		}
+		return;
+	}
+
+	SC4Rect<int32_t> segmentBounds{};
+	std::vector<RowSpan> spans;
+
+	// The first pass finds the bounds of the path, the second draws the segments.
+	SC4Rect<int32_t> bounds{};
+
+	for (size_t i = 1; i < vertices.size(); i++)
+	{
+		GetLineSpans(vertices[i - 1], vertices[i], width, segmentBounds, spans);
+
+		if (i == 1)
+		{
+			bounds = segmentBounds;
+		}
+		else
+		{
+			bounds.topLeftX = (std::min)(bounds.topLeftX, segmentBounds.topLeftX);
+			bounds.topLeftY = (std::min)(bounds.topLeftY, segmentBounds.topLeftY);
+			bounds.bottomRightX = (std::max)(bounds.bottomRightX, segmentBounds.bottomRightX);
+			bounds.bottomRightY = (std::max)(bounds.bottomRightY, segmentBounds.bottomRightY);
+		}
+	}
+
+	region.Reset(bounds.topLeftX, bounds.topLeftY, bounds.bottomRightX, bounds.bottomRightY);
+
+	for (size_t i = 1; i < vertices.size(); i++)
+	{
+		GetLineSpans(vertices[i - 1], vertices[i], width, segmentBounds, spans);
+
+		const int32_t rowOffset = segmentBounds.topLeftY - bounds.topLeftY;
+		const int32_t columnOffset = segmentBounds.topLeftX - bounds.topLeftX;
+
+		for (size_t z = 0; z < spans.size(); z++)
+		{
+			region.FillRowSpan(
+				static_cast<uint32_t>(rowOffset + static_cast<int32_t>(z)),
+				spans[z].start + columnOffset,
+				spans[z].end + columnOffset,
+				true);
+		}
+	}
+}
+
+CellRegionRasterizer::CellPoint CellRegionRasterizer::SnapLineEnd(const CellPoint& start, const CellPoint& end, int32_t angleStep)
+{
+	const int32_t dx = end.x - start.x;
+	const int32_t dz = end.z - start.z;
+
+	if ((dx == 0 && dz == 0) || angleStep <= 0)
+	{
+		return end;
+	}
+
+	constexpr double kPi = 3.14159265358979323846;
+
+	const double step = angleStep * (kPi / 180.0);
+	const double angle = std::round(std::atan2(static_cast<double>(dz), static_cast<double>(dx)) / step) * step;
+	const double length = std::sqrt(static_cast<double>(dx) * dx + static_cast<double>(dz) * dz);
+
+	return CellPoint
+	{
+		start.x + static_cast<int32_t>(std::lround(std::cos(angle) * length)),
+		start.z + static_cast<int32_t>(std::lround(std::sin(angle) * length)),
+	};
+}
+
+void CellRegionRasterizer::RasterizePolygon(const std::vector<CellPoint>& vertices, BitsetCellRegion& region)
+{
+	if (vertices.empty())
+	{
+		region.Reset(0, 0, -1, -1);
+		return;
+	}
+
+	int32_t minX = vertices[0].x;
+	int32_t minZ = vertices[0].z;
+	int32_t maxX = vertices[0].x;
+	int32_t maxZ = vertices[0].z;
+
+	for (const CellPoint& vertex : vertices)
+	{
+		minX = (std::min)(minX, vertex.x);
+		minZ = (std::min)(minZ, vertex.z);
+		maxX = (std::max)(maxX, vertex.x);
+		maxZ = (std::max)(maxZ, vertex.z);
+	}
+
+	region.Reset(minX, minZ, maxX, maxZ);
+
+	const size_t vertexCount = vertices.size();
+
+	// Build the edge table, sorted by the first row each edge crosses.
+	// Each edge covers the rows in [minZ, maxZ), so a vertex shared by two edges is only
+	// counted once. Horizontal edges do not cross any rows, they are covered by the outline.
+	std::vector<PolygonEdge> edgeTable;
+	edgeTable.reserve(vertexCount);
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		CellPoint start = vertices[i];
+		CellPoint end = vertices[(i + 1) % vertexCount];
+
+		if (start.z == end.z)
+		{
+			continue;
+		}
+
+		if (start.z > end.z)
+		{
+			std::swap(start, end);
+		}
+
+		const int32_t dz = end.z - start.z;
+
+		edgeTable.push_back(PolygonEdge
+		{
+			start.z,
+			end.z,
+			static_cast<int64_t>(start.x) * dz,
+			end.x - start.x,
+			dz
+		});
+	}
+
+	std::sort(
+		edgeTable.begin(),
+		edgeTable.end(),
+		[](const PolygonEdge& a, const PolygonEdge& b) { return a.minZ < b.minZ; });
+
+	std::vector<PolygonEdge> activeEdges;
+	activeEdges.reserve(edgeTable.size());
+
+	size_t nextEdge = 0;
+
+	for (int32_t z = minZ; z <= maxZ; z++)
+	{
+		activeEdges.erase(
+			std::remove_if(
+				activeEdges.begin(),
+				activeEdges.end(),
+				[z](const PolygonEdge& edge) { return edge.maxZ <= z; }),
+			activeEdges.end());
+
+		while (nextEdge < edgeTable.size() && edgeTable[nextEdge].minZ == z)
+		{
+			activeEdges.push_back(edgeTable[nextEdge]);
+			nextEdge++;
+		}
+
+		// The active edges stay mostly sorted between rows, so an insertion sort is used.
+		for (size_t i = 1; i < activeEdges.size(); i++)
+		{
+			const PolygonEdge edge = activeEdges[i];
+			size_t j = i;
+
+			while (j > 0 && IsEdgeLeftOf(edge, activeEdges[j - 1]))
+			{
+				activeEdges[j] = activeEdges[j - 1];
+				j--;
+			}
+
+			activeEdges[j] = edge;
+		}
+
+		// Fill the cells between each pair of crossings.
+		for (size_t i = 0; i + 1 < activeEdges.size(); i += 2)
+		{
+			const PolygonEdge& left = activeEdges[i];
+			const PolygonEdge& right = activeEdges[i + 1];
+
+			const int64_t start = CeilDivide(left.xNumerator, left.dz);
+			const int64_t end = FloorDivide(right.xNumerator, right.dz);
+
+			region.FillRowSpan(
+				static_cast<uint32_t>(z - minZ),
+				static_cast<int32_t>(start - minX),
+				static_cast<int32_t>(end - minX),
+				true);
+		}
+
+		for (PolygonEdge& edge : activeEdges)
+		{
+			edge.xNumerator += edge.dx;
+		}
+	}
+
+	for (size_t i = 0; i < vertexCount; i++)
+	{
+		DrawLine(region, vertices[i], vertices[(i + 1) % vertexCount]);
+	}
+}
+
+void CellRegionRasterizer::FillRowSpan(cRZCellMap& cellMap, uint32_t z, int32_t start, int32_t end, bool value)
+{
+	for (int32_t x = start; x <= end; x++)
+	{
+		cellMap.SetValue(static_cast<uint32_t>(x), z, value);
+	}
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BitsetCellRegion.h"
+#include "SC4CellRegion.h"
+#include <cstdint>
+#include <vector>
+
+namespace CellRegionRasterizer
+{
+	struct CellPoint
+	{
+		int32_t x;
+		int32_t z;
+
+		bool operator==(const CellPoint& other) const = default;
+	};
+
+	// The cells of a region row that are part of a shape, relative to the region's left edge.
+	// The span is empty when start is greater than end.
+	struct RowSpan
+	{
+		int32_t start;
+		int32_t end;
+
+		bool IsEmpty() const
+		{
+			return start > end;
+		}
+	};
+
+	// Creates a region covering the bounding box of the two points with a diagonal line
+	// drawn between two of its corners.
+	// The corners are chosen based on which quadrant of the bounding box the start point
+	// is located in, if no start point is provided the line is drawn from NW to SE.
+	// A positive thickness extends the line to the right/bottom, a negative thickness extends
+	// it to the left/top.
+	SC4CellRegion<int32_t> CreateDiagonalRegion(
+		int32_t x1,
+		int32_t z1,
+		int32_t x2,
+		int32_t z2,
+		int32_t thickness,
+		int32_t startX = -1,
+		int32_t startZ = -1);
+
+	// Draws the diagonal line into an existing region, using the region bounds as
+	// the line's bounding box. The rest of the region is cleared.
+	// Returns false if the region bounds are invalid.
+	bool RasterizeDiagonal(
+		SC4CellRegion<int32_t>& region,
+		int32_t thickness,
+		int32_t startX = -1,
+		int32_t startZ = -1);
+
+	// Gets the cells of the diagonal line that CreateDiagonalRegion would set as one span
+	// for each row of the bounding box.
+	// The thick line is built from the per-row extents of the Bresenham line, so the cost
+	// is proportional to the number of rows instead of the line length times the thickness.
+	void GetDiagonalSpans(
+		int32_t x1,
+		int32_t z1,
+		int32_t x2,
+		int32_t z2,
+		int32_t thickness,
+		int32_t startX,
+		int32_t startZ,
+		std::vector<RowSpan>& spans);
+
+	// Writes one span per row into the region, the cells outside of the spans are cleared.
+	// Returns false if the region bounds are invalid or do not match the span count.
+	bool FillRegion(SC4CellRegion<int32_t>& region, const std::vector<RowSpan>& spans);
+
+	// Gets one span per row for an ellipse that fills a width by height bounding box.
+	// The spans are built from the quadrant outline of the midpoint ellipse algorithm, so the
+	// cost is proportional to the perimeter instead of the area.
+	void GetEllipseSpans(int32_t width, int32_t height, std::vector<RowSpan>& spans);
+
+	// Draws an ellipse that fills the specified bounding box into the region, the region
+	// is resized to the bounding box.
+	void RasterizeEllipse(int32_t minX, int32_t minZ, int32_t maxX, int32_t maxZ, BitsetCellRegion& region);
+
+	// Gets the cells of a line between two points as one span per row of the line's bounds.
+	// The line is stepped along its major axis with a 16.16 fixed-point DDA, and the width is
+	// measured perpendicular to the line and centered on it.
+	void GetLineSpans(
+		const CellPoint& start,
+		const CellPoint& end,
+		int32_t width,
+		SC4Rect<int32_t>& bounds,
+		std::vector<RowSpan>& spans);
+
+	// Draws a line between two points into the region, the region is resized to the line's bounds.
+	void RasterizeLine(const CellPoint& start, const CellPoint& end, int32_t width, BitsetCellRegion& region);
+
+	// Draws the segments of an open path into the region, the region is resized to the path's bounds.
+	// The segments are combined in the region, so the cells where they overlap are only included once.
+	void RasterizePolyline(const std::vector<CellPoint>& vertices, int32_t width, BitsetCellRegion& region);
+
+	// Moves the line end point so that the line angle is a multiple of angleStep degrees,
+	// the length of the line is preserved.
+	CellPoint SnapLineEnd(const CellPoint& start, const CellPoint& end, int32_t angleStep);
+
+	// Draws a closed polygon into the region, the region is resized to the polygon's bounding box.
+	// The interior is filled with an edge table scanline fill using the even-odd rule, and the
+	// cells under the polygon edges are always included. A polygon with fewer than 3 vertices
+	// produces a line or a single cell.
+	void RasterizePolygon(const std::vector<CellPoint>& vertices, BitsetCellRegion& region);
+
+	// Sets the cells in [start, end] of the specified row.
+	void FillRowSpan(cRZCellMap& cellMap, uint32_t z, int32_t start, int32_t end, bool value);
+}
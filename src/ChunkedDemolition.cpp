@@ -0,0 +1,139 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "ChunkedDemolition.h"
+
+ChunkedDemolition::ChunkedDemolition()
+	: region(),
+	  chunk(),
+	  maxCellsPerChunk(0),
+	  nextRow(0),
+	  chunkCellCount(0),
+	  completedCellCount(0),
+	  totalCellCount(0),
+	  totalCost(0),
+	  result(false),
+	  active(false)
+{
+}
+
+void ChunkedDemolition::Start(const SC4CellRegion<int32_t>& region, uint64_t maxCellsPerChunk)
+{
+	this->region.CopyFrom(region);
+	this->maxCellsPerChunk = maxCellsPerChunk;
+	nextRow = 0;
+	chunkCellCount = 0;
+	completedCellCount = 0;
+	totalCellCount = this->region.PopCount();
+	totalCost = 0;
+	result = false;
+	active = totalCellCount > 0;
+}
+
+bool ChunkedDemolition::IsActive() const
+{
+	return active;
+}
+
+const BitsetCellRegion* ChunkedDemolition::GetNextChunk()
+{
+	if (!active)
+	{
+		return nullptr;
+	}
+
+	const uint32_t height = region.GetHeight();
+
+	// Skip the rows that have no selected cells.
+	while (nextRow < height && region.PopCountRow(nextRow) == 0)
+	{
+		nextRow++;
+	}
+
+	if (nextRow >= height)
+	{
+		active = false;
+		return nullptr;
+	}
+
+	const uint32_t firstRow = nextRow;
+	uint64_t cellCount = 0;
+
+	while (nextRow < height)
+	{
+		const uint64_t rowCellCount = region.PopCountRow(nextRow);
+
+		if (cellCount > 0 && cellCount + rowCellCount > maxCellsPerChunk)
+		{
+			break;
+		}
+
+		cellCount += rowCellCount;
+		nextRow++;
+	}
+
+	const SC4Rect<int32_t>& bounds = region.GetBounds();
+
+	chunk.Reset(
+		bounds.topLeftX,
+		bounds.topLeftY + static_cast<int32_t>(firstRow),
+		bounds.bottomRightX,
+		bounds.topLeftY + static_cast<int32_t>(nextRow - 1));
+	chunk.CopyFrom(region);
+	chunkCellCount = cellCount;
+
+	return &chunk;
+}
+
+void ChunkedDemolition::CompleteChunk(bool result, int64_t cost)
+{
+	completedCellCount += chunkCellCount;
+	chunkCellCount = 0;
+	totalCost += cost;
+	this->result |= result;
+}
+
+void ChunkedDemolition::Cancel()
+{
+	active = false;
+	chunkCellCount = 0;
+}
+
+uint64_t ChunkedDemolition::GetCompletedCellCount() const
+{
+	return completedCellCount;
+}
+
+uint64_t ChunkedDemolition::GetTotalCellCount() const
+{
+	return totalCellCount;
+}
+
+int64_t ChunkedDemolition::GetTotalCost() const
+{
+	return totalCost;
+}
+
+bool ChunkedDemolition::GetResult() const
+{
+	return result;
+}
@@ -0,0 +1,72 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "BitsetCellRegion.h"
+#include "SC4CellRegion.h"
+#include <cstdint>
+
+// Splits a large demolition into bands of rows that are demolished over several frames,
+// so that committing a selection that covers a whole city tile does not block the game.
+//
+// The caller demolishes each chunk with the bulldoze mode's filter and passes the result
+// to CompleteChunk, the totals of all chunks match a single demolition of the region.
+class ChunkedDemolition
+{
+public:
+	ChunkedDemolition();
+
+	// Starts the demolition of the region's selected cells.
+	// Each chunk holds whole rows with at most maxCellsPerChunk selected cells, a row that
+	// has more selected cells than that is a chunk of its own.
+	void Start(const SC4CellRegion<int32_t>& region, uint64_t maxCellsPerChunk);
+
+	// Returns true if there are chunks that have not been demolished.
+	bool IsActive() const;
+
+	// Gets the next chunk, returns nullptr when all of the chunks have been demolished.
+	const BitsetCellRegion* GetNextChunk();
+
+	// Adds the result of demolishing the chunk from the last GetNextChunk call.
+	void CompleteChunk(bool result, int64_t cost);
+
+	// Stops the demolition, the remaining chunks are not demolished.
+	void Cancel();
+
+	uint64_t GetCompletedCellCount() const;
+	uint64_t GetTotalCellCount() const;
+	int64_t GetTotalCost() const;
+	// Returns true if any of the chunk demolitions succeeded.
+	bool GetResult() const;
+
+private:
+	BitsetCellRegion region;
+	BitsetCellRegion chunk;
+	uint64_t maxCellsPerChunk;
+	uint32_t nextRow;
+	uint64_t chunkCellCount;
+	uint64_t completedCellCount;
+	uint64_t totalCellCount;
+	int64_t totalCost;
+	bool result;
+	bool active;
+};
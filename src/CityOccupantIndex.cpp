@@ -0,0 +1,229 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "CityOccupantIndex.h"
+#include "cISC4City.h"
+#include "cISC4Lot.h"
+#include "cISC4LotManager.h"
+#include "cISC4NetworkOccupant.h"
+#include "cISC4Occupant.h"
+#include "cISC4OccupantManager.h"
+#include "cRZAutoRefCount.h"
+#include "cS3DBoundingBox.h"
+#include "GlobalCityPointers.h"
+#include "Logger.h"
+#include "NetworkTypeFlags.h"
+#include "OccupantTypes.h"
+#include "SC4List.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+	constexpr float kCellSize = 16.0f;
+
+	int32_t GetCellIndex(float coordinate)
+	{
+		return static_cast<int32_t>(std::floor(coordinate / kCellSize));
+	}
+
+	uint32_t GetNetworkFlags(cISC4Occupant* pOccupant)
+	{
+		uint32_t flags = 0;
+
+		cRZAutoRefCount<cISC4NetworkOccupant> networkOccupant;
+
+		if (pOccupant->QueryInterface(GZIID_cISC4NetworkOccupant, networkOccupant.AsPPVoid()))
+		{
+			constexpr uint32_t kLastNetworkFlag = static_cast<uint32_t>(NetworkTypeFlags::GroundHighway);
+
+			for (uint32_t flag = 1; flag <= kLastNetworkFlag; flag <<= 1)
+			{
+				if (networkOccupant->HasAnyNetworkFlag(flag))
+				{
+					flags |= flag;
+				}
+			}
+		}
+
+		return flags;
+	}
+}
+
+CityOccupantIndex::CityOccupantIndex()
+	: spatialIndex(),
+	  occupants(),
+	  initialized(false)
+{
+}
+
+void CityOccupantIndex::Init(cISC4City* pCity)
+{
+	if (initialized || !pCity)
+	{
+		return;
+	}
+
+	cISC4OccupantManager* pOccupantManager = pCity->GetOccupantManager();
+
+	if (!pOccupantManager)
+	{
+		Logger::GetInstance().WriteLine(
+			LogLevel::Error,
+			"Failed to get the city's occupant manager, the occupant index is disabled.");
+		return;
+	}
+
+	const int32_t cellCountX = static_cast<int32_t>(pCity->CellCountX());
+	const int32_t cellCountZ = static_cast<int32_t>(pCity->CellCountZ());
+
+	spatialIndex.Reset(cellCountX, cellCountZ);
+	initialized = true;
+
+	SC4List<cISC4Occupant*> occupantList;
+
+	if (pOccupantManager->GetOccupantList(occupantList, nullptr))
+	{
+		occupants.reserve(occupantList.size());
+
+		for (cISC4Occupant* pOccupant : occupantList)
+		{
+			OccupantInserted(pOccupant);
+		}
+	}
+}
+
+void CityOccupantIndex::Shutdown()
+{
+	if (initialized)
+	{
+		initialized = false;
+		occupants.clear();
+		spatialIndex.Reset(0, 0);
+	}
+}
+
+void CityOccupantIndex::OccupantInserted(cISC4Occupant* pOccupant)
+{
+	if (!initialized || !pOccupant || occupants.contains(pOccupant))
+	{
+		return;
+	}
+
+	OccupantInfo info{};
+
+	if (GetOccupantInfo(pOccupant, info))
+	{
+		spatialIndex.Insert(info.cellBounds, info.entry);
+		occupants.emplace(pOccupant, info);
+	}
+}
+
+void CityOccupantIndex::OccupantRemoved(cISC4Occupant* pOccupant)
+{
+	if (!initialized)
+	{
+		return;
+	}
+
+	const auto it = occupants.find(pOccupant);
+
+	if (it != occupants.end())
+	{
+		// The stored values are used because the occupant may already be partially destroyed.
+		const OccupantInfo& info = it->second;
+
+		spatialIndex.Remove(info.cellBounds, pOccupant);
+		occupants.erase(it);
+	}
+}
+
+const OccupantSpatialIndex* CityOccupantIndex::GetSpatialIndex() const
+{
+	return initialized ? &spatialIndex : nullptr;
+}
+
+bool CityOccupantIndex::RemoveCellsWithoutOccupants(BitsetCellRegion& region, uint32_t categoryFlags)
+{
+	if (!initialized)
+	{
+		return false;
+	}
+
+	spatialIndex.RemoveCellsWithoutOccupants(region, categoryFlags);
+	return true;
+}
+
+bool CityOccupantIndex::GetOccupantInfo(cISC4Occupant* pOccupant, OccupantInfo& info) const
+{
+	cS3DBoundingBox boundingBox;
+
+	if (!pOccupant->GetBoundingBox(boundingBox))
+	{
+		return false;
+	}
+
+	const int32_t minX = GetCellIndex(boundingBox.minBounds.fX);
+	const int32_t minZ = GetCellIndex(boundingBox.minBounds.fZ);
+
+	// An occupant that ends on a cell edge does not extend into the next cell.
+	info.cellBounds.topLeftX = minX;
+	info.cellBounds.topLeftY = minZ;
+	info.cellBounds.bottomRightX = std::max(minX, static_cast<int32_t>(std::ceil(boundingBox.maxBounds.fX / kCellSize)) - 1);
+	info.cellBounds.bottomRightY = std::max(minZ, static_cast<int32_t>(std::ceil(boundingBox.maxBounds.fZ / kCellSize)) - 1);
+
+	OccupantSpatialIndex::Entry& entry = info.entry;
+	entry.pOccupant = pOccupant;
+	entry.category = OccupantCategory::Other;
+	entry.networkFlags = 0;
+	entry.zoneType = cISC4ZoneManager::ZoneType::None;
+
+	const uint32_t type = pOccupant->GetType();
+
+	if (type == kFloraOccupantType)
+	{
+		entry.category = OccupantCategory::Flora;
+	}
+	else
+	{
+		if (IsPossibleNetworkOccupantType(type))
+		{
+			entry.networkFlags = GetNetworkFlags(pOccupant);
+		}
+
+		if ((entry.networkFlags & static_cast<uint32_t>(NetworkTypeFlags::AllTransportationNetworks)) != 0)
+		{
+			entry.category = OccupantCategory::Network;
+		}
+		else if (entry.networkFlags == 0 && spLotManager)
+		{
+			cISC4Lot* pLot = spLotManager->GetOccupantLot(pOccupant);
+
+			if (pLot)
+			{
+				entry.category = OccupantCategory::Lot;
+				entry.zoneType = pLot->GetZoneType();
+			}
+		}
+	}
+
+	return true;
+}
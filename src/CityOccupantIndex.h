@@ -0,0 +1,61 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "ICityOccupantIndex.h"
+#include "OccupantSpatialIndex.h"
+#include <unordered_map>
+
+class cISC4City;
+class cISC4Occupant;
+
+// Tracks the city's occupants by cell and category, so that the bulldoze tool can tell
+// which cells of a selection hold the occupants that a mode demolishes without asking the game.
+//
+// The index is built when a city is loaded and updated from the occupant insert and
+// remove messages.
+class CityOccupantIndex : public ICityOccupantIndex
+{
+public:
+	CityOccupantIndex();
+
+	void Init(cISC4City* pCity);
+	void Shutdown();
+
+	void OccupantInserted(cISC4Occupant* pOccupant);
+	void OccupantRemoved(cISC4Occupant* pOccupant);
+
+	const OccupantSpatialIndex* GetSpatialIndex() const;
+	bool RemoveCellsWithoutOccupants(BitsetCellRegion& region, uint32_t categoryFlags);
+
+private:
+	struct OccupantInfo
+	{
+		SC4Rect<int32_t> cellBounds;
+		OccupantSpatialIndex::Entry entry;
+	};
+
+	bool GetOccupantInfo(cISC4Occupant* pOccupant, OccupantInfo& info) const;
+
+	OccupantSpatialIndex spatialIndex;
+	std::unordered_map<cISC4Occupant*, OccupantInfo> occupants;
+	bool initialized;
+};
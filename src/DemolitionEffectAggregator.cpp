@@ -0,0 +1,260 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DemolitionEffectAggregator.h"
+#include "OccupantSpatialIndex.h"
+#include <algorithm>
+
+DemolitionEffectAggregator::DemolitionEffectAggregator()
+	: binSize(1),
+	  binCountX(0),
+	  bins(),
+	  cellOccupantCounts(),
+	  visitedOccupants(),
+	  effectCells(),
+	  quietCells(),
+	  effectCount(0),
+	  maxEffects(0)
+{
+}
+
+bool DemolitionEffectAggregator::Aggregate(
+	const OccupantSpatialIndex& index,
+	const BitsetCellRegion& selectedCells,
+	uint32_t categoryFlags,
+	uint32_t maxEffects)
+{
+	const SC4Rect<int32_t>& bounds = selectedCells.GetBounds();
+	const uint32_t width = selectedCells.GetWidth();
+	const uint32_t height = selectedCells.GetHeight();
+
+	effectCount = 0;
+	this->maxEffects = maxEffects;
+
+	// Use the smallest square bins that keep the grid within the effect limit.
+	const uint32_t maxBins = std::max(maxEffects, 1u);
+	uint32_t binCountZ = 0;
+	binSize = 1;
+
+	while (true)
+	{
+		binCountX = (width + binSize - 1) / binSize;
+		binCountZ = (height + binSize - 1) / binSize;
+
+		if (static_cast<uint64_t>(binCountX) * binCountZ <= maxBins)
+		{
+			break;
+		}
+
+		binSize *= 2;
+	}
+
+	bins.assign(static_cast<size_t>(binCountX) * binCountZ, Bin{});
+	cellOccupantCounts.assign(static_cast<size_t>(width) * height, 0);
+	visitedOccupants.Clear();
+
+	uint64_t occupantCount = 0;
+
+	for (uint32_t z = 0; z < height; z++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			if (selectedCells.GetValue(x, z))
+			{
+				const uint32_t count = CountCellOccupants(
+					index,
+					bounds.topLeftX + static_cast<int32_t>(x),
+					bounds.topLeftY + static_cast<int32_t>(z),
+					categoryFlags);
+
+				cellOccupantCounts[(static_cast<size_t>(z) * width) + x] = count;
+				bins[((z / binSize) * binCountX) + (x / binSize)].occupantCount += count;
+				occupantCount += count;
+			}
+		}
+	}
+
+	if (occupantCount <= maxEffects)
+	{
+		return false;
+	}
+
+	// Each bin with occupants keeps one effect, the rest are shared in proportion to the
+	// number of occupants that the bin removes.
+	uint32_t occupiedBinCount = 0;
+
+	for (const Bin& bin : bins)
+	{
+		if (bin.occupantCount > 0)
+		{
+			occupiedBinCount++;
+		}
+	}
+
+	const uint32_t sharedEffects = maxEffects > occupiedBinCount ? maxEffects - occupiedBinCount : 0;
+	const uint32_t baseEffects = maxEffects > 0 ? 1 : 0;
+
+	// The shares are rounded on the running total, so they add up to the shared effects.
+	uint64_t sharedOccupants = 0;
+	uint64_t sharedTotal = 0;
+
+	for (Bin& bin : bins)
+	{
+		if (bin.occupantCount > 0)
+		{
+			sharedOccupants += bin.occupantCount;
+
+			const uint64_t nextSharedTotal = sharedEffects * sharedOccupants / occupantCount;
+			const uint64_t share = nextSharedTotal - sharedTotal;
+			sharedTotal = nextSharedTotal;
+
+			bin.effectCount = static_cast<uint32_t>(std::min<uint64_t>(bin.occupantCount, baseEffects + share));
+			bin.fallbackCount = UINT32_MAX;
+		}
+	}
+
+	effectCells.Reset(bounds.topLeftX, bounds.topLeftY, bounds.bottomRightX, bounds.bottomRightY);
+
+	// Spread the effects of each bin evenly over its occupants, a cell is picked when one of
+	// the bin's sample positions falls on its occupants.
+	for (uint32_t z = 0; z < height; z++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			const uint32_t cellIndex = (z * width) + x;
+			const uint32_t count = cellOccupantCounts[cellIndex];
+
+			if (count == 0)
+			{
+				continue;
+			}
+
+			Bin& bin = bins[((z / binSize) * binCountX) + (x / binSize)];
+
+			const uint64_t visit = bin.visitCount;
+			bin.visitCount += count;
+
+			if (count < bin.fallbackCount)
+			{
+				bin.fallbackCell = cellIndex;
+				bin.fallbackCount = count;
+			}
+
+			const uint64_t effects = bin.effectCount;
+			const uint64_t binOccupants = bin.occupantCount;
+
+			if ((visit + count) * effects / binOccupants > visit * effects / binOccupants
+				&& bin.pickedCount + count <= bin.effectCount
+				&& TryPickEffectCell(cellIndex, count))
+			{
+				bin.pickedCount += count;
+			}
+		}
+	}
+
+	// A bin whose sampled cells all hold more occupants than its share uses its emptiest cell,
+	// as long as the operation has effects left for it.
+	for (Bin& bin : bins)
+	{
+		if (bin.effectCount > 0
+			&& bin.pickedCount == 0
+			&& TryPickEffectCell(bin.fallbackCell, bin.fallbackCount))
+		{
+			bin.pickedCount = bin.fallbackCount;
+		}
+	}
+
+	// The sampled cells may have more occupants than the effects that are left in their bin,
+	// the rest of the bin's effects go to the other cells that fit.
+	for (uint32_t z = 0; z < height; z++)
+	{
+		for (uint32_t x = 0; x < width; x++)
+		{
+			const uint32_t count = cellOccupantCounts[(z * width) + x];
+			Bin& bin = bins[((z / binSize) * binCountX) + (x / binSize)];
+
+			if (count > 0
+				&& bin.pickedCount + count <= bin.effectCount
+				&& !effectCells.GetValue(x, z)
+				&& TryPickEffectCell((z * width) + x, count))
+			{
+				bin.pickedCount += count;
+			}
+		}
+	}
+
+	quietCells.Reset(bounds.topLeftX, bounds.topLeftY, bounds.bottomRightX, bounds.bottomRightY);
+	quietCells.CopyFrom(selectedCells);
+	quietCells.Subtract(effectCells);
+
+	return true;
+}
+
+size_t DemolitionEffectAggregator::GetEffectCount() const
+{
+	return effectCount;
+}
+
+const BitsetCellRegion& DemolitionEffectAggregator::GetEffectCells() const
+{
+	return effectCells;
+}
+
+const BitsetCellRegion& DemolitionEffectAggregator::GetQuietCells() const
+{
+	return quietCells;
+}
+
+uint32_t DemolitionEffectAggregator::CountCellOccupants(
+	const OccupantSpatialIndex& index,
+	int32_t x,
+	int32_t z,
+	uint32_t categoryFlags)
+{
+	uint32_t count = 0;
+
+	for (const OccupantSpatialIndex::Entry& entry : index.GetCellOccupants(x, z))
+	{
+		// An occupant that covers more than one cell is counted in the first selected cell.
+		if ((categoryFlags & GetOccupantCategoryFlag(entry.category)) != 0
+			&& (!entry.coversMultipleCells || visitedOccupants.Insert(entry.pOccupant)))
+		{
+			count++;
+		}
+	}
+
+	return count;
+}
+
+bool DemolitionEffectAggregator::TryPickEffectCell(uint32_t cellIndex, uint32_t count)
+{
+	if (effectCount + count > maxEffects)
+	{
+		return false;
+	}
+
+	const uint32_t width = effectCells.GetWidth();
+
+	effectCells.SetValue(cellIndex % width, cellIndex / width, true);
+	effectCount += count;
+	return true;
+}
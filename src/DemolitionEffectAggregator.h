@@ -0,0 +1,95 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "BitsetCellRegion.h"
+#include "OccupantSet.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class OccupantSpatialIndex;
+
+// Caps the number of demolition effects that one bulldoze operation spawns.
+//
+// The game spawns an effect for each occupant that a DemolishRegion call with the effect
+// arguments removes, so the effects are capped by choosing the cells that are demolished with
+// those arguments. The selection is divided into a coarse grid with at most maxEffects bins,
+// each bin that has occupants keeps the effects of at least one cell and the remaining effects
+// are shared out in proportion to the number of occupants that each bin removes. The effect
+// arguments have no intensity that could be scaled, so a bin that removes more gets more effects.
+// The cells that keep their effects are sampled evenly from the bin, a cell is only picked if
+// its occupants fit in the effects that are left, so the effect cells never hold more than
+// maxEffects of the counted occupants.
+//
+// The caller demolishes GetEffectCells with the game's effect arguments and GetQuietCells
+// without them. The two regions do not overlap, so each selected cell is visited by one call.
+// The occupant counts come from the city occupant index, they only decide where the effects
+// are placed and not which occupants are demolished.
+class DemolitionEffectAggregator
+{
+public:
+	DemolitionEffectAggregator();
+
+	// Splits the selected cells into the cells that keep their demolition effects and the rest,
+	// the occupants in the categories of categoryFlags are counted.
+	// Returns false if the selection has no more than maxEffects occupants, all of them keep
+	// their effect.
+	bool Aggregate(
+		const OccupantSpatialIndex& index,
+		const BitsetCellRegion& selectedCells,
+		uint32_t categoryFlags,
+		uint32_t maxEffects);
+
+	// The number of occupants in the effect cells, it does not exceed maxEffects.
+	size_t GetEffectCount() const;
+
+	const BitsetCellRegion& GetEffectCells() const;
+	const BitsetCellRegion& GetQuietCells() const;
+
+private:
+	struct Bin
+	{
+		uint32_t occupantCount;
+		uint32_t effectCount;
+		uint32_t visitCount;
+		uint32_t pickedCount;
+		// The selected cell of the bin with the fewest occupants, used when none of the sampled
+		// cells fit in the bin's effects.
+		uint32_t fallbackCell;
+		uint32_t fallbackCount;
+	};
+
+	uint32_t CountCellOccupants(const OccupantSpatialIndex& index, int32_t x, int32_t z, uint32_t categoryFlags);
+	// Adds a cell to the effect cells, returns false if its occupants do not fit in the effects that are left.
+	bool TryPickEffectCell(uint32_t cellIndex, uint32_t count);
+
+	uint32_t binSize;
+	uint32_t binCountX;
+	std::vector<Bin> bins;
+	std::vector<uint32_t> cellOccupantCounts;
+	OccupantSet visitedOccupants;
+	BitsetCellRegion effectCells;
+	BitsetCellRegion quietCells;
+	size_t effectCount;
+	uint32_t maxEffects;
+};
@@ -20,13 +20,24 @@
  */
 
 #pragma once
-#include "NetworkOccupantFilterBase.h"
-
-class DezoneKeepNetworksOccupantFilter : public NetworkOccupantFilterBase
-{
-public:
-	DezoneKeepNetworksOccupantFilter();
-
-	bool IsOccupantIncluded(cISC4Occupant* pOccupant) override;
-};
+#include "PredicateOccupantFilter.h"
 
+// Exclude all networks from demolition, only the zoned areas will be demolished.
+//
+// We limit the tool to RCI zones.
+// The Maxis dezone tool ignores the Plopped zone type, but unlike our version
+// it can remove empty landfill zones.
+// Landfill zones being ignored may be an artifact of the dezoning implementation
+// in cISC4Demolition::DemolishRegion.
+using DezoneKeepNetworksOccupantFilter = PredicateOccupantFilter<
+	And<Not<HasNetworkFlags<NetworkTypeFlags::AllTransportationNetworks>>,
+		LotZoneIn<
+			cISC4ZoneManager::ZoneType::ResidentialLowDensity,
+			cISC4ZoneManager::ZoneType::ResidentialMediumDensity,
+			cISC4ZoneManager::ZoneType::ResidentialHighDensity,
+			cISC4ZoneManager::ZoneType::CommercialLowDensity,
+			cISC4ZoneManager::ZoneType::CommercialMediumDensity,
+			cISC4ZoneManager::ZoneType::CommercialHighDensity,
+			cISC4ZoneManager::ZoneType::Agriculture,
+			cISC4ZoneManager::ZoneType::IndustrialMediumDensity,
+			cISC4ZoneManager::ZoneType::IndustrialHighDensity>>>;
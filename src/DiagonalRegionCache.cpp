@@ -0,0 +1,176 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "DiagonalRegionCache.h"
+#include <algorithm>
+
+DiagonalRegionCache::DiagonalRegionCache()
+	: lastDestination(nullptr),
+	  key(),
+	  lineSpans(),
+	  newLineSpans(),
+	  unsetCell()
+{
+}
+
+bool DiagonalRegionCache::Apply(
+	SC4CellRegion<int32_t>& destination,
+	int32_t thickness,
+	int32_t startX,
+	int32_t startZ)
+{
+	const auto& bounds = destination.bounds;
+
+	if (bounds.topLeftX > bounds.bottomRightX || bounds.topLeftY > bounds.bottomRightY)
+	{
+		return false;
+	}
+
+	const Key newKey
+	{
+		bounds.topLeftX,
+		bounds.topLeftY,
+		bounds.bottomRightX,
+		bounds.bottomRightY,
+		thickness,
+		startX,
+		startZ
+	};
+
+	const bool destinationHasLine = DestinationHasLine(destination);
+
+	if (destinationHasLine && key == newKey)
+	{
+		// The destination already contains the diagonal.
+		return true;
+	}
+
+	CellRegionRasterizer::GetDiagonalSpans(
+		newKey.minX,
+		newKey.minZ,
+		newKey.maxX,
+		newKey.maxZ,
+		thickness,
+		startX,
+		startZ,
+		newLineSpans);
+
+	if (destinationHasLine && key.HasSameBounds(newKey))
+	{
+		// Only the line changed, update the cells that differ.
+		for (size_t z = 0; z < newLineSpans.size(); z++)
+		{
+			PatchRow(destination.cellMap, static_cast<uint32_t>(z), lineSpans[z], newLineSpans[z]);
+		}
+	}
+	else
+	{
+		// The bounds changed or the game reset the region, none of the old cells can be kept.
+		CellRegionRasterizer::FillRegion(destination, newLineSpans);
+	}
+
+	lastDestination = &destination;
+	key = newKey;
+	lineSpans.swap(newLineSpans);
+	unsetCell = FindUnsetCell();
+
+	return true;
+}
+
+void DiagonalRegionCache::Invalidate()
+{
+	lastDestination = nullptr;
+	lineSpans.clear();
+	unsetCell.reset();
+}
+
+bool DiagonalRegionCache::Key::HasSameBounds(const Key& other) const
+{
+	return minX == other.minX
+		&& minZ == other.minZ
+		&& maxX == other.maxX
+		&& maxZ == other.maxZ;
+}
+
+bool DiagonalRegionCache::DestinationHasLine(const SC4CellRegion<int32_t>& destination) const
+{
+	if (lastDestination != &destination)
+	{
+		return false;
+	}
+
+	const auto& bounds = destination.bounds;
+
+	if (bounds.topLeftX != key.minX ||
+		bounds.topLeftY != key.minZ ||
+		bounds.bottomRightX != key.maxX ||
+		bounds.bottomRightY != key.maxZ)
+	{
+		return false;
+	}
+
+	return !unsetCell || !destination.cellMap.GetValue(unsetCell->x, unsetCell->z);
+}
+
+std::optional<DiagonalRegionCache::CellPoint> DiagonalRegionCache::FindUnsetCell() const
+{
+	const int32_t width = key.maxX - key.minX + 1;
+
+	// The line starts in a corner of the region, so there is almost always
+	// an unset cell in the first row.
+	for (size_t z = 0; z < lineSpans.size(); z++)
+	{
+		const RowSpan& span = lineSpans[z];
+
+		if (span.IsEmpty() || span.start > 0)
+		{
+			return CellPoint{ 0, static_cast<uint32_t>(z) };
+		}
+		else if (span.end < width - 1)
+		{
+			return CellPoint{ static_cast<uint32_t>(span.end + 1), static_cast<uint32_t>(z) };
+		}
+	}
+
+	return std::nullopt;
+}
+
+void DiagonalRegionCache::PatchRow(cRZCellMap& cellMap, uint32_t z, const RowSpan& oldSpan, const RowSpan& newSpan)
+{
+	if (oldSpan.IsEmpty())
+	{
+		CellRegionRasterizer::FillRowSpan(cellMap, z, newSpan.start, newSpan.end, true);
+	}
+	else if (newSpan.IsEmpty())
+	{
+		CellRegionRasterizer::FillRowSpan(cellMap, z, oldSpan.start, oldSpan.end, false);
+	}
+	else
+	{
+		// Clear the parts of the old span that are outside the new span.
+		CellRegionRasterizer::FillRowSpan(cellMap, z, oldSpan.start, (std::min)(oldSpan.end, newSpan.start - 1), false);
+		CellRegionRasterizer::FillRowSpan(cellMap, z, (std::max)(oldSpan.start, newSpan.end + 1), oldSpan.end, false);
+
+		// Set the parts of the new span that are outside the old span.
+		CellRegionRasterizer::FillRowSpan(cellMap, z, newSpan.start, (std::min)(newSpan.end, oldSpan.start - 1), true);
+		CellRegionRasterizer::FillRowSpan(cellMap, z, (std::max)(newSpan.start, oldSpan.end + 1), newSpan.end, true);
+	}
+}
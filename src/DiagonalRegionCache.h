@@ -0,0 +1,95 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "CellRegionRasterizer.h"
+#include "SC4CellRegion.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+// Tracks the diagonal that was last drawn into the view control's region, so that the
+// preview, mode switch and mouse up code paths only rasterize it once for each distinct
+// selection.
+//
+// When the selection changes without changing the region bounds, e.g. the thickness is
+// adjusted with the mouse wheel, only the cells that differ between the old and new line
+// are written instead of the whole region.
+//
+// Growing or shrinking the drag is not incremental. The game recreates the view control's
+// cell map as a filled rectangle when the bounds change, so every cell outside of the line
+// has to be cleared again and the region is rebuilt from the line's row spans.
+class DiagonalRegionCache
+{
+public:
+	DiagonalRegionCache();
+
+	// Draws the diagonal into the destination region, using the region bounds as the
+	// line's bounding box. Nothing is written if the region already contains the diagonal.
+	// Returns false if the region bounds are invalid.
+	bool Apply(
+		SC4CellRegion<int32_t>& destination,
+		int32_t thickness,
+		int32_t startX,
+		int32_t startZ);
+
+	void Invalidate();
+
+private:
+	struct Key
+	{
+		int32_t minX;
+		int32_t minZ;
+		int32_t maxX;
+		int32_t maxZ;
+		int32_t thickness;
+		int32_t startX;
+		int32_t startZ;
+
+		bool HasSameBounds(const Key& other) const;
+
+		bool operator==(const Key& other) const = default;
+	};
+
+	struct CellPoint
+	{
+		uint32_t x;
+		uint32_t z;
+	};
+
+	using RowSpan = CellRegionRasterizer::RowSpan;
+
+	// Checks that the destination still contains the line that was last drawn into it.
+	bool DestinationHasLine(const SC4CellRegion<int32_t>& destination) const;
+
+	// Finds a cell that is not part of the line, this is used to detect when
+	// the game has reset the destination region to a rectangle.
+	std::optional<CellPoint> FindUnsetCell() const;
+
+	// Updates the cells of a row that differ between the old and new span.
+	static void PatchRow(cRZCellMap& cellMap, uint32_t z, const RowSpan& oldSpan, const RowSpan& newSpan);
+
+	const SC4CellRegion<int32_t>* lastDestination;
+	Key key;
+	std::vector<RowSpan> lineSpans;
+	std::vector<RowSpan> newLineSpans;
+	std::optional<CellPoint> unsetCell;
+};
@@ -0,0 +1,108 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ExpressionOccupantFilter.h"
+#include "cISC4Lot.h"
+#include "cISC4LotManager.h"
+#include "cISC4NetworkOccupant.h"
+#include "cISC4Occupant.h"
+#include "cRZAutoRefCount.h"
+#include "GlobalCityPointers.h"
+#include "OccupantTypes.h"
+
+using TestType = OccupantFilterProgram::TestType;
+
+ExpressionOccupantFilter::ExpressionOccupantFilter(const OccupantFilterProgram& program)
+	: program(program),
+	  includedTypeClasses(program.GetIncludedTypeClasses()),
+	  acceptedTypeClasses(program.GetAcceptedTypeClasses())
+{
+}
+
+bool ExpressionOccupantFilter::IsOccupantIncluded(cISC4Occupant* pOccupant)
+{
+	if (!pOccupant)
+	{
+		return false;
+	}
+
+	const uint32_t type = pOccupant->GetType();
+	const uint32_t typeClass = OccupantFilterProgram::GetOccupantTypeClass(type);
+
+	if ((acceptedTypeClasses & typeClass) != 0)
+	{
+		return true;
+	}
+
+	const std::vector<OccupantFilterProgram::Instruction>& instructions = program.GetInstructions();
+
+	// The network occupant and lot are looked up the first time that a test needs them.
+	cRZAutoRefCount<cISC4NetworkOccupant> networkOccupant;
+	bool networkOccupantQueried = false;
+	uint32_t lotZoneBit = 0;
+
+	uint16_t target = program.GetEntryPoint();
+
+	while (target < OccupantFilterProgram::kReject)
+	{
+		const OccupantFilterProgram::Instruction& instruction = instructions[target];
+		bool passed = false;
+
+		switch (instruction.type)
+		{
+		case TestType::OccupantType:
+			passed = (instruction.mask & typeClass) != 0;
+			break;
+		case TestType::NetworkFlags:
+			if (!networkOccupantQueried)
+			{
+				networkOccupantQueried = true;
+
+				if (IsPossibleNetworkOccupantType(type))
+				{
+					pOccupant->QueryInterface(GZIID_cISC4NetworkOccupant, networkOccupant.AsPPVoid());
+				}
+			}
+
+			passed = networkOccupant && networkOccupant->HasAnyNetworkFlag(instruction.mask);
+			break;
+		case TestType::LotZone:
+			if (lotZoneBit == 0)
+			{
+				cISC4Lot* pLot = spLotManager ? spLotManager->GetOccupantLot(pOccupant) : nullptr;
+
+				lotZoneBit = pLot ? 1U << static_cast<uint32_t>(pLot->GetZoneType()) : OccupantFilterProgram::kNoLotZoneBit;
+			}
+
+			passed = (instruction.mask & lotZoneBit) != 0;
+			break;
+		}
+
+		target = passed ? instruction.ifTrue : instruction.ifFalse;
+	}
+
+	return target == OccupantFilterProgram::kAccept;
+}
+
+bool ExpressionOccupantFilter::IsOccupantTypeIncluded(uint32_t type)
+{
+	return (includedTypeClasses & OccupantFilterProgram::GetOccupantTypeClass(type)) != 0;
+}
@@ -20,13 +20,6 @@
  */
 
 #pragma once
-#include "cSC4BaseOccupantFilter.h"
-
-class FloraOccupantFilter : public cSC4BaseOccupantFilter
-{
-public:
-	FloraOccupantFilter();
-
-	bool IsOccupantTypeIncluded(uint32_t type) override;
-};
+#include "PredicateOccupantFilter.h"
 
+using FloraOccupantFilter = PredicateOccupantFilter<IsFloraType>;
@@ -0,0 +1,38 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BitsetCellRegion.h"
+
+class OccupantSpatialIndex;
+
+class ICityOccupantIndex
+{
+public:
+	// Gets the occupants by cell, returns nullptr if the index is not available.
+	virtual const OccupantSpatialIndex* GetSpatialIndex() const = 0;
+
+	// Clears the cells of the region that do not contain an occupant in one of the categories.
+	// Returns false if the index is not available.
+	virtual bool RemoveCellsWithoutOccupants(BitsetCellRegion& region, uint32_t categoryFlags) = 0;
+};
+
+extern ICityOccupantIndex* spCityOccupantIndex;
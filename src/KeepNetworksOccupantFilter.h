@@ -20,13 +20,6 @@
  */
 
 #pragma once
-#include "NetworkOccupantFilterBase.h"
-
-class KeepNetworksOccupantFilter :  public NetworkOccupantFilterBase
-{
-public:
-	KeepNetworksOccupantFilter(NetworkTypeFlags networkFlags);
-
-	bool IsOccupantIncluded(cISC4Occupant* pOccupant) override;
-};
+#include "PredicateOccupantFilter.h"
 
+using KeepNetworksOccupantFilter = PredicateOccupantFilter<Not<HasNetworkFlags<NetworkTypeFlags::AllTransportationNetworks>>>;
@@ -20,15 +20,25 @@
  */
 
 #include "Logger.h"
+#include <cstdarg>
+#include <cstdio>
+#include <memory>
+
+#ifdef _WIN32
 #include <Windows.h>
+#endif // _WIN32
 
 namespace
 {
 #ifdef _DEBUG
 	void PrintLineToDebugOutput(const char* line)
 	{
+#ifdef _WIN32
 		OutputDebugStringA(line);
 		OutputDebugStringA("\n");
+#else
+		std::fprintf(stderr, "%s\n", line);
+#endif // _WIN32
 	}
 #endif // _DEBUG
 }
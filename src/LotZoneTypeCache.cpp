@@ -0,0 +1,135 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "LotZoneTypeCache.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr uint32_t kInitialIndexBits = 6;
+}
+
+LotZoneTypeCache::LotZoneTypeCache()
+	: slots(static_cast<size_t>(1) << kInitialIndexBits, Slot{ nullptr, cISC4ZoneManager::ZoneType::None }),
+	  indexBits(kInitialIndexBits),
+	  count(0),
+	  lastSlot{ nullptr, cISC4ZoneManager::ZoneType::None }
+{
+}
+
+bool LotZoneTypeCache::TryGet(const cISC4Lot* pLot, cISC4ZoneManager::ZoneType& zoneType) const
+{
+	bool result = false;
+
+	if (pLot)
+	{
+		if (lastSlot.pLot == pLot)
+		{
+			zoneType = lastSlot.zoneType;
+			result = true;
+		}
+		else
+		{
+			const Slot& slot = slots[GetSlotIndex(pLot)];
+
+			if (slot.pLot == pLot)
+			{
+				lastSlot = slot;
+				zoneType = slot.zoneType;
+				result = true;
+			}
+		}
+	}
+
+	return result;
+}
+
+void LotZoneTypeCache::Add(const cISC4Lot* pLot, cISC4ZoneManager::ZoneType zoneType)
+{
+	if (!pLot)
+	{
+		return;
+	}
+
+	// The table is kept at most half full so that the probe sequences stay short.
+	if ((count + 1) * 2 > slots.size())
+	{
+		Grow();
+	}
+
+	Slot& slot = slots[GetSlotIndex(pLot)];
+
+	if (!slot.pLot)
+	{
+		slot.pLot = pLot;
+		count++;
+	}
+
+	slot.zoneType = zoneType;
+	lastSlot = slot;
+}
+
+void LotZoneTypeCache::Clear()
+{
+	std::fill(slots.begin(), slots.end(), Slot{ nullptr, cISC4ZoneManager::ZoneType::None });
+	count = 0;
+	lastSlot = Slot{ nullptr, cISC4ZoneManager::ZoneType::None };
+}
+
+size_t LotZoneTypeCache::GetCount() const
+{
+	return count;
+}
+
+size_t LotZoneTypeCache::GetSlotIndex(const cISC4Lot* pLot) const
+{
+	// Fibonacci hashing, the high bits of the product are used as the starting index.
+	const uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pLot)) * 0x9E3779B97F4A7C15ull;
+	const size_t mask = slots.size() - 1;
+
+	size_t index = static_cast<size_t>(hash >> (64 - indexBits));
+
+	// Linear probing, the search ends at the lot's slot or the first empty slot.
+	while (slots[index].pLot && slots[index].pLot != pLot)
+	{
+		index = (index + 1) & mask;
+	}
+
+	return index;
+}
+
+void LotZoneTypeCache::Grow()
+{
+	std::vector<Slot> oldSlots(
+		static_cast<size_t>(1) << (indexBits + 1),
+		Slot{ nullptr, cISC4ZoneManager::ZoneType::None });
+
+	oldSlots.swap(slots);
+	indexBits++;
+
+	for (const Slot& slot : oldSlots)
+	{
+		if (slot.pLot)
+		{
+			slots[GetSlotIndex(slot.pLot)] = slot;
+		}
+	}
+}
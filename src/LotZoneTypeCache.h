@@ -0,0 +1,62 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cISC4ZoneManager.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class cISC4Lot;
+
+// A small open-addressing hash table from a lot to its zone type.
+//
+// A grown lot has many occupants, the cache lets an occupant filter resolve each lot's
+// zone type once per demolition instead of once per occupant.
+class LotZoneTypeCache
+{
+public:
+	LotZoneTypeCache();
+
+	bool TryGet(const cISC4Lot* pLot, cISC4ZoneManager::ZoneType& zoneType) const;
+	void Add(const cISC4Lot* pLot, cISC4ZoneManager::ZoneType zoneType);
+
+	void Clear();
+
+	size_t GetCount() const;
+
+private:
+	struct Slot
+	{
+		const cISC4Lot* pLot;
+		cISC4ZoneManager::ZoneType zoneType;
+	};
+
+	size_t GetSlotIndex(const cISC4Lot* pLot) const;
+	void Grow();
+
+	std::vector<Slot> slots;
+	uint32_t indexBits;
+	size_t count;
+	// The occupants of a lot are usually visited one after another, the last lot that
+	// was found is checked before the table.
+	mutable Slot lastSlot;
+};
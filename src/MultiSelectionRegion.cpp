@@ -0,0 +1,152 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MultiSelectionRegion.h"
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+	SC4Rect<int32_t> GetUnionBounds(const SC4Rect<int32_t>& a, const SC4Rect<int32_t>& b)
+	{
+		return SC4Rect<int32_t>
+		{
+			std::min(a.topLeftX, b.topLeftX),
+			std::min(a.topLeftY, b.topLeftY),
+			std::max(a.bottomRightX, b.bottomRightX),
+			std::max(a.bottomRightY, b.bottomRightY),
+		};
+	}
+}
+
+MultiSelectionRegion::MultiSelectionRegion()
+	: selection(),
+	  dragRegion(),
+	  scratch(),
+	  combined(),
+	  combinedRegion(),
+	  version(0),
+	  empty(true)
+{
+}
+
+bool MultiSelectionRegion::IsEmpty() const
+{
+	return empty;
+}
+
+uint32_t MultiSelectionRegion::GetVersion() const
+{
+	return version;
+}
+
+void MultiSelectionRegion::Add(const SC4CellRegion<int32_t>& region)
+{
+	dragRegion.CopyFrom(region);
+	Add(dragRegion);
+}
+
+void MultiSelectionRegion::Add(const BitsetCellRegion& region)
+{
+	SC4Rect<int32_t> dragBounds;
+
+	if (!region.GetSetCellBounds(dragBounds))
+	{
+		return;
+	}
+
+	const SC4Rect<int32_t> selectionBounds = empty ? dragBounds : GetUnionBounds(selection.GetBounds(), dragBounds);
+
+	SetSelection(selectionBounds);
+	empty = false;
+
+	selection.Unite(region);
+	version++;
+}
+
+void MultiSelectionRegion::Subtract(const SC4CellRegion<int32_t>& region)
+{
+	if (empty)
+	{
+		return;
+	}
+
+	dragRegion.CopyFrom(region);
+	Subtract(dragRegion);
+}
+
+void MultiSelectionRegion::Subtract(const BitsetCellRegion& region)
+{
+	if (empty)
+	{
+		return;
+	}
+
+	selection.Subtract(region);
+	version++;
+
+	SC4Rect<int32_t> setCellBounds;
+
+	if (selection.GetSetCellBounds(setCellBounds))
+	{
+		// Shrink the selection so that the game does not scan the cells that were removed.
+		SetSelection(setCellBounds);
+	}
+	else
+	{
+		Clear();
+	}
+}
+
+void MultiSelectionRegion::Clear()
+{
+	selection.Reset(0, 0, -1, -1);
+	empty = true;
+	version++;
+}
+
+const SC4CellRegion<int32_t>& MultiSelectionRegion::Combine(const SC4CellRegion<int32_t>& currentRegion)
+{
+	dragRegion.CopyFrom(currentRegion);
+
+	const SC4Rect<int32_t> bounds = empty ? dragRegion.GetBounds() : GetUnionBounds(selection.GetBounds(), dragRegion.GetBounds());
+
+	combined.Reset(bounds.topLeftX, bounds.topLeftY, bounds.bottomRightX, bounds.bottomRightY);
+	combined.Unite(selection);
+	combined.Unite(dragRegion);
+
+	return combined.CopyTo(combinedRegion);
+}
+
+void MultiSelectionRegion::SetSelection(const SC4Rect<int32_t>& bounds)
+{
+	const SC4Rect<int32_t>& selectionBounds = selection.GetBounds();
+
+	if (selectionBounds.topLeftX != bounds.topLeftX
+		|| selectionBounds.topLeftY != bounds.topLeftY
+		|| selectionBounds.bottomRightX != bounds.bottomRightX
+		|| selectionBounds.bottomRightY != bounds.bottomRightY)
+	{
+		scratch.Reset(bounds.topLeftX, bounds.topLeftY, bounds.bottomRightX, bounds.bottomRightY);
+		scratch.Unite(selection);
+		std::swap(selection, scratch);
+	}
+}
@@ -0,0 +1,61 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BitsetCellRegion.h"
+#include "SC4CellRegion.h"
+
+// The cells that the user has added to the bulldoze selection with previous drags.
+// The selection is demolished together with the final drag, so the game only needs
+// to run a single demolition for the whole area.
+class MultiSelectionRegion
+{
+public:
+	MultiSelectionRegion();
+
+	bool IsEmpty() const;
+
+	// Gets a number that changes each time the selection is modified.
+	uint32_t GetVersion() const;
+
+	void Add(const SC4CellRegion<int32_t>& region);
+	void Add(const BitsetCellRegion& region);
+	void Subtract(const SC4CellRegion<int32_t>& region);
+	void Subtract(const BitsetCellRegion& region);
+	void Clear();
+
+	// Gets the union of the selection and the region of the current drag.
+	// The returned region is overwritten by the next call.
+	const SC4CellRegion<int32_t>& Combine(const SC4CellRegion<int32_t>& currentRegion);
+
+private:
+	void SetSelection(const SC4Rect<int32_t>& bounds);
+
+	BitsetCellRegion selection;
+	BitsetCellRegion dragRegion;
+	BitsetCellRegion scratch;
+	// The combined region is kept between the mouse moves of a drag, so that its storage
+	// is only reallocated when the bounds grow.
+	BitsetCellRegion combined;
+	ReusableCellRegion combinedRegion;
+	uint32_t version;
+	bool empty;
+};
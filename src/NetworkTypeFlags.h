@@ -20,7 +20,7 @@
  */
 
 #pragma once
-#include "cSC4BaseOccupantFilter.h"
+#include <cstdint>
 #include <type_traits>
 
 enum class NetworkTypeFlags : uint32_t
@@ -71,15 +71,3 @@ inline NetworkTypeFlags& operator&=(NetworkTypeFlags& lhs, NetworkTypeFlags rhs)
 
 	return reinterpret_cast<NetworkTypeFlags&>(reinterpret_cast<T&>(lhs) &= static_cast<T>(rhs));
 }
-
-class NetworkOccupantFilterBase : public cSC4BaseOccupantFilter
-{
-protected:
-	NetworkOccupantFilterBase(NetworkTypeFlags networkFlags);
-
-	bool IsNetworkOccupant(cISC4Occupant* pOccupant) const;
-
-private:
-	uint32_t networkFlags;
-};
-
@@ -0,0 +1,55 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// The occupant groups that the bulldoze modes include or exclude.
+enum class OccupantCategory : uint32_t
+{
+	Flora = 0,
+	// Transportation network occupants, other networks such as pipes and power lines
+	// are in the Other category.
+	Network = 1,
+	// Occupants that belong to a lot.
+	// An occupant that is not on its lot yet when it is inserted is in the Other category,
+	// the bulldoze modes always include or exclude the Lot and Other categories together.
+	Lot = 2,
+	Other = 3,
+};
+
+static constexpr size_t kOccupantCategoryCount = 4;
+
+enum OccupantCategoryFlags : uint32_t
+{
+	OccupantCategoryFlagNone = 0,
+	OccupantCategoryFlagFlora = 1 << static_cast<uint32_t>(OccupantCategory::Flora),
+	OccupantCategoryFlagNetwork = 1 << static_cast<uint32_t>(OccupantCategory::Network),
+	OccupantCategoryFlagLot = 1 << static_cast<uint32_t>(OccupantCategory::Lot),
+	OccupantCategoryFlagOther = 1 << static_cast<uint32_t>(OccupantCategory::Other),
+	OccupantCategoryFlagAll = OccupantCategoryFlagFlora | OccupantCategoryFlagNetwork | OccupantCategoryFlagLot | OccupantCategoryFlagOther,
+};
+
+inline constexpr uint32_t GetOccupantCategoryFlag(OccupantCategory category)
+{
+	return uint32_t(1) << static_cast<uint32_t>(category);
+}
@@ -0,0 +1,176 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OccupantClassificationMemo.h"
+
+namespace
+{
+	// A full tile selection of a typical city fits in the table without growing.
+	constexpr uint32_t kInitialIndexBits = 12;
+
+	constexpr OccupantClassificationMemo::Classification kUnknownClassification
+	{
+		0,
+		nullptr,
+		cISC4ZoneManager::ZoneType::None,
+		OccupantClassificationMemo::ClassificationFlagNone
+	};
+}
+
+OccupantClassificationMemo::OccupantClassificationMemo()
+	: slots(static_cast<size_t>(1) << kInitialIndexBits, Slot{ nullptr, kUnknownClassification }),
+	  indexBits(kInitialIndexBits),
+	  count(0),
+	  removedLots()
+{
+}
+
+OccupantClassificationMemo::Classification& OccupantClassificationMemo::Get(cISC4Occupant* pOccupant)
+{
+	// The table is kept at most half full so that the probe sequences stay short.
+	if ((count + 1) * 2 > slots.size())
+	{
+		Grow();
+	}
+
+	Slot& slot = slots[GetSlotIndex(pOccupant)];
+	Classification& classification = slot.classification;
+
+	if (!slot.pOccupant)
+	{
+		slot.pOccupant = pOccupant;
+		classification = kUnknownClassification;
+		count++;
+	}
+	else if ((classification.flags & ClassificationFlagLot) != 0 && removedLots.GetCount() > 0)
+	{
+		cISC4ZoneManager::ZoneType removedZoneType = cISC4ZoneManager::ZoneType::None;
+
+		if (removedLots.TryGet(classification.pLot, removedZoneType))
+		{
+			classification.flags &= ~(ClassificationFlagLotKnown | ClassificationFlagLot);
+		}
+	}
+
+	return classification;
+}
+
+void OccupantClassificationMemo::Remove(cISC4Occupant* pOccupant)
+{
+	if (!pOccupant)
+	{
+		return;
+	}
+
+	size_t index = GetSlotIndex(pOccupant);
+
+	if (slots[index].pOccupant != pOccupant)
+	{
+		return;
+	}
+
+	const Classification& classification = slots[index].classification;
+
+	if ((classification.flags & ClassificationFlagLot) != 0)
+	{
+		removedLots.Add(classification.pLot, classification.zoneType);
+	}
+
+	const size_t mask = slots.size() - 1;
+
+	// Move the later occupants of the probe sequence back into the empty slot, so that the
+	// searches that passed the removed occupant still reach them.
+	for (size_t next = (index + 1) & mask; slots[next].pOccupant; next = (next + 1) & mask)
+	{
+		const size_t home = GetHomeIndex(slots[next].pOccupant);
+
+		if (((next - home) & mask) >= ((next - index) & mask))
+		{
+			slots[index] = slots[next];
+			index = next;
+		}
+	}
+
+	slots[index].pOccupant = nullptr;
+	count--;
+}
+
+void OccupantClassificationMemo::Clear()
+{
+	if (count > 0)
+	{
+		for (Slot& slot : slots)
+		{
+			slot.pOccupant = nullptr;
+		}
+
+		count = 0;
+	}
+
+	if (removedLots.GetCount() > 0)
+	{
+		removedLots.Clear();
+	}
+}
+
+size_t OccupantClassificationMemo::GetCount() const
+{
+	return count;
+}
+
+size_t OccupantClassificationMemo::GetHomeIndex(const cISC4Occupant* pOccupant) const
+{
+	// Fibonacci hashing, the high bits of the product are used as the starting index.
+	const uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pOccupant)) * 0x9E3779B97F4A7C15ull;
+
+	return static_cast<size_t>(hash >> (64 - indexBits));
+}
+
+size_t OccupantClassificationMemo::GetSlotIndex(const cISC4Occupant* pOccupant) const
+{
+	const size_t mask = slots.size() - 1;
+
+	size_t index = GetHomeIndex(pOccupant);
+
+	// Linear probing, the search ends at the occupant's slot or the first empty slot.
+	while (slots[index].pOccupant && slots[index].pOccupant != pOccupant)
+	{
+		index = (index + 1) & mask;
+	}
+
+	return index;
+}
+
+void OccupantClassificationMemo::Grow()
+{
+	std::vector<Slot> oldSlots(static_cast<size_t>(1) << (indexBits + 1), Slot{ nullptr, kUnknownClassification });
+
+	oldSlots.swap(slots);
+	indexBits++;
+
+	for (const Slot& slot : oldSlots)
+	{
+		if (slot.pOccupant)
+		{
+			slots[GetSlotIndex(slot.pOccupant)] = slot;
+		}
+	}
+}
@@ -0,0 +1,94 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "cISC4ZoneManager.h"
+#include "LotZoneTypeCache.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class cISC4Lot;
+class cISC4Occupant;
+
+// Remembers how the occupant filters classified each occupant, so that the repeated
+// preview dry runs of an overlapping selection use a hash lookup instead of the
+// cISC4NetworkOccupant and lot manager calls.
+//
+// The classifications are stored in an open-addressing table that is reserved up front and
+// keeps its storage when it is cleared, so a lookup does not allocate once the table has
+// grown to the size of the selections.
+//
+// The memo is scoped to a bulldoze tool session. An occupant that is removed from the city
+// must be removed from the memo, the occupant pointer may be reused by a new occupant.
+class OccupantClassificationMemo
+{
+public:
+	enum ClassificationFlags : uint8_t
+	{
+		ClassificationFlagNone = 0,
+		ClassificationFlagNetworkKnown = 1 << 0,
+		ClassificationFlagNetwork = 1 << 1,
+		ClassificationFlagLotKnown = 1 << 2,
+		ClassificationFlagLot = 1 << 3,
+	};
+
+	struct Classification
+	{
+		// The network type flags that the network result was computed for.
+		uint32_t networkFlags;
+		// The occupant's lot and its zone type, only valid when the lot flag is set.
+		const cISC4Lot* pLot;
+		cISC4ZoneManager::ZoneType zoneType;
+		uint8_t flags;
+	};
+
+	OccupantClassificationMemo();
+
+	// Gets the classification of an occupant, a new occupant starts with no known values.
+	// The occupant must not be null, the reference is valid until the memo is changed.
+	Classification& Get(cISC4Occupant* pOccupant);
+
+	// Forgets the classification of a removed occupant. The lot may have been removed with it,
+	// so the lot of the other occupants on the same lot is queried again on their next lookup.
+	void Remove(cISC4Occupant* pOccupant);
+
+	void Clear();
+
+	size_t GetCount() const;
+
+private:
+	struct Slot
+	{
+		cISC4Occupant* pOccupant;
+		Classification classification;
+	};
+
+	size_t GetHomeIndex(const cISC4Occupant* pOccupant) const;
+	size_t GetSlotIndex(const cISC4Occupant* pOccupant) const;
+	void Grow();
+
+	std::vector<Slot> slots;
+	uint32_t indexBits;
+	size_t count;
+	// The lots of the removed occupants, with the zone type that they had.
+	LotZoneTypeCache removedLots;
+};
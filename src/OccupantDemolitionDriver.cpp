@@ -0,0 +1,117 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OccupantDemolitionDriver.h"
+
+OccupantDemolitionDriver::MemoFilter::MemoFilter(OccupantDemolitionDriver& driver)
+	: driver(driver)
+{
+}
+
+bool OccupantDemolitionDriver::MemoFilter::IsOccupantTypeIncluded(uint32_t type)
+{
+	return !driver.pFilter || driver.pFilter->IsOccupantTypeIncluded(type);
+}
+
+bool OccupantDemolitionDriver::MemoFilter::IsOccupantIncluded(cISC4Occupant* pOccupant)
+{
+	return driver.IsOccupantIncluded(pOccupant);
+}
+
+OccupantDemolitionDriver::OccupantDemolitionDriver()
+	: pFilter(nullptr),
+	  testedOccupants(),
+	  selectedOccupants(),
+	  testedCount(0),
+	  selectedCount(0),
+	  selectionLimit(kNoSelectionLimit),
+	  selectionLimitReached(false),
+	  memoFilter(new MemoFilter(*this))
+{
+}
+
+cISC4OccupantFilter* OccupantDemolitionDriver::Begin(cISC4OccupantFilter* pFilter)
+{
+	this->pFilter = pFilter;
+	testedOccupants.Clear();
+	selectedOccupants.Clear();
+	testedCount = 0;
+	selectedCount = 0;
+	selectionLimit = kNoSelectionLimit;
+	selectionLimitReached = false;
+
+	return memoFilter;
+}
+
+void OccupantDemolitionDriver::SetSelectionLimit(size_t limit)
+{
+	selectionLimit = limit;
+}
+
+bool OccupantDemolitionDriver::IsSelectionLimitReached() const
+{
+	return selectionLimitReached;
+}
+
+void OccupantDemolitionDriver::OccupantRemoved(cISC4Occupant* pOccupant)
+{
+	if (testedOccupants.Remove(pOccupant))
+	{
+		selectedOccupants.Remove(pOccupant);
+	}
+}
+
+size_t OccupantDemolitionDriver::GetTestedCount() const
+{
+	return testedCount;
+}
+
+size_t OccupantDemolitionDriver::GetSelectedCount() const
+{
+	return selectedCount;
+}
+
+bool OccupantDemolitionDriver::IsOccupantIncluded(cISC4Occupant* pOccupant)
+{
+	if (!testedOccupants.Insert(pOccupant))
+	{
+		return selectedOccupants.Contains(pOccupant);
+	}
+
+	if (selectedCount >= selectionLimit)
+	{
+		testedOccupants.Remove(pOccupant);
+		selectionLimitReached = true;
+		return false;
+	}
+
+	testedCount++;
+
+	if (!pFilter || pFilter->IsOccupantIncluded(pOccupant))
+	{
+		selectedOccupants.Insert(pOccupant);
+		selectedCount++;
+		return true;
+	}
+
+	return false;
+}
@@ -0,0 +1,84 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "cRZAutoRefCount.h"
+#include "cSC4BaseOccupantFilter.h"
+#include "OccupantSet.h"
+#include <cstddef>
+#include <cstdint>
+
+// Tests each occupant of a DemolishRegion call against the bulldoze mode's filter once.
+//
+// The game's demolition loop visits an occupant in every selected cell that it covers and
+// asks the filter each time. The driver's filter is passed to the game in place of the mode's
+// filter and keeps the answer for each occupant, the game still enumerates the occupants
+// so the result does not depend on the city occupant index.
+class OccupantDemolitionDriver
+{
+public:
+	static constexpr size_t kNoSelectionLimit = SIZE_MAX;
+
+	OccupantDemolitionDriver();
+
+	// Starts a DemolishRegion call, returns the filter that is passed to the game.
+	cISC4OccupantFilter* Begin(cISC4OccupantFilter* pFilter);
+
+	// Limits the number of occupants that the filter selects, the occupants over the limit are
+	// excluded without being remembered so that a later call with a higher limit tests them again.
+	void SetSelectionLimit(size_t limit);
+
+	// Returns true if an occupant was excluded because of the selection limit since Begin.
+	bool IsSelectionLimitReached() const;
+
+	// Forgets the answer for a removed occupant, its pointer may be reused by an occupant
+	// that the game creates later in the same call.
+	void OccupantRemoved(cISC4Occupant* pOccupant);
+
+	// The number of distinct occupants that were passed to the mode's filter.
+	size_t GetTestedCount() const;
+	size_t GetSelectedCount() const;
+
+private:
+	class MemoFilter : public cSC4BaseOccupantFilter
+	{
+	public:
+		MemoFilter(OccupantDemolitionDriver& driver);
+
+		bool IsOccupantTypeIncluded(uint32_t type) override;
+		bool IsOccupantIncluded(cISC4Occupant* pOccupant) override;
+
+	private:
+		OccupantDemolitionDriver& driver;
+	};
+
+	bool IsOccupantIncluded(cISC4Occupant* pOccupant);
+
+	cISC4OccupantFilter* pFilter;
+	OccupantSet testedOccupants;
+	OccupantSet selectedOccupants;
+	size_t testedCount;
+	size_t selectedCount;
+	size_t selectionLimit;
+	bool selectionLimitReached;
+	cRZAutoRefCount<MemoFilter> memoFilter;
+};
@@ -0,0 +1,188 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OccupantFilterExpressions.h"
+#include "cGZPersistResourceKey.h"
+#include "cIGZPersistResourceManager.h"
+#include "cIGZVariant.h"
+#include "cISCProperty.h"
+#include "cISCPropertyHolder.h"
+#include "cISCResExemplar.h"
+#include "ExpressionOccupantFilter.h"
+#include "GZServPtrs.h"
+#include "Logger.h"
+#include "OccupantFilterProgram.h"
+#include <string>
+#include <string_view>
+
+namespace
+{
+	bool GetStringProperty(const cISCPropertyHolder* pPropertyHolder, uint32_t propertyID, std::string_view& value)
+	{
+		bool result = false;
+
+		if (pPropertyHolder)
+		{
+			const cISCProperty* pProperty = pPropertyHolder->GetProperty(propertyID);
+
+			if (pProperty)
+			{
+				const cIGZVariant* pVariant = pProperty->GetPropertyValue();
+
+				if (pVariant)
+				{
+					if (pVariant->GetType() == cIGZVariant::RZCharArray)
+					{
+						value = std::string_view(pVariant->RefRZChar(), pVariant->GetCount());
+						result = true;
+					}
+					else
+					{
+						Logger::GetInstance().WriteLineFormatted(
+							LogLevel::Error,
+							"Bulldoze Extensions Tuning Exemplar property 0x%08X must be a String.",
+							propertyID);
+					}
+				}
+			}
+		}
+
+		return result;
+	}
+
+	cRZAutoRefCount<cISC4OccupantFilter> CreateFilter(const OccupantFilterProgram& program)
+	{
+		return cRZAutoRefCount<cISC4OccupantFilter>(new ExpressionOccupantFilter(program));
+	}
+}
+
+OccupantFilterExpressions::OccupantFilterExpressions()
+	: filters(),
+	  initialized(false)
+{
+}
+
+void OccupantFilterExpressions::Init()
+{
+	if (initialized)
+	{
+		return;
+	}
+
+	initialized = true;
+
+	cIGZPersistResourceManagerPtr pRM;
+
+	if (!pRM)
+	{
+		return;
+	}
+
+	const cGZPersistResourceKey tuningExemplarKey(0x6534284A, 0xF527AC8F, 0x89EB3FF3);
+
+	cRZAutoRefCount<cISCResExemplar> pExemplar;
+
+	if (!pRM->GetResource(tuningExemplarKey, GZIID_cISCResExemplar, pExemplar.AsPPVoid(), 0, nullptr))
+	{
+		return;
+	}
+
+	constexpr uint32_t kFloraFilterPropertyID = 0x8FD94ED3;
+	constexpr uint32_t kNetworkFilterPropertyID = 0x8FD94ED4;
+	constexpr uint32_t kDezoneKeepNetworksFilterPropertyID = 0x8FD94ED5;
+
+	constexpr std::array<uint32_t, 3> kPropertyIDs =
+	{
+		kFloraFilterPropertyID,
+		kNetworkFilterPropertyID,
+		kDezoneKeepNetworksFilterPropertyID,
+	};
+
+	Logger& logger = Logger::GetInstance();
+	const cISCPropertyHolder* pPropertyHolder = pExemplar->AsISCPropertyHolder();
+
+	for (uint32_t propertyID : kPropertyIDs)
+	{
+		std::string_view expression;
+
+		if (!GetStringProperty(pPropertyHolder, propertyID, expression))
+		{
+			continue;
+		}
+
+		OccupantFilterProgram program;
+		std::string error;
+
+		if (!program.Compile(expression, error))
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Error,
+				"Failed to compile the filter expression in property 0x%08X: %s",
+				propertyID,
+				error.c_str());
+			continue;
+		}
+
+		logger.WriteLineFormatted(
+			LogLevel::Info,
+			"Using the filter expression in property 0x%08X: %.*s",
+			propertyID,
+			static_cast<int>(expression.size()),
+			expression.data());
+
+		switch (propertyID)
+		{
+		case kFloraFilterPropertyID:
+			filters[static_cast<size_t>(FilterType::Flora)] = CreateFilter(program);
+			break;
+		case kNetworkFilterPropertyID:
+			// The network mode removes the occupants that match the expression, or
+			// keeps them when Shift is held.
+			filters[static_cast<size_t>(FilterType::RemoveNetworks)] = CreateFilter(program);
+			program.Negate();
+			filters[static_cast<size_t>(FilterType::KeepNetworks)] = CreateFilter(program);
+			break;
+		case kDezoneKeepNetworksFilterPropertyID:
+			filters[static_cast<size_t>(FilterType::DezoneKeepNetworks)] = CreateFilter(program);
+			break;
+		}
+	}
+}
+
+void OccupantFilterExpressions::Shutdown()
+{
+	if (initialized)
+	{
+		initialized = false;
+
+		for (auto& filter : filters)
+		{
+			filter = nullptr;
+		}
+	}
+}
+
+cISC4OccupantFilter* OccupantFilterExpressions::GetOccupantFilter(FilterType type) const
+{
+	const size_t index = static_cast<size_t>(type);
+
+	return index < filters.size() ? static_cast<cISC4OccupantFilter*>(filters[index]) : nullptr;
+}
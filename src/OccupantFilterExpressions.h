@@ -19,29 +19,27 @@
  * If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include "NetworkOccupantFilterBase.h"
-#include "cISC4NetworkOccupant.h"
-#include "cISC4Occupant.h"
+#pragma once
+#include "IOccupantFilterExpressions.h"
+#include "cISC4OccupantFilter.h"
 #include "cRZAutoRefCount.h"
+#include <array>
 
-NetworkOccupantFilterBase::NetworkOccupantFilterBase(NetworkTypeFlags networkTypeFlags)
-	: networkFlags(static_cast<uint32_t>(networkTypeFlags))
+// Loads the optional filter expressions from the Bulldoze Extensions Tuning Exemplar and
+// compiles them into the occupant filters that replace the built-in filter classes.
+class OccupantFilterExpressions : public IOccupantFilterExpressions
 {
-}
+public:
+	OccupantFilterExpressions();
 
-bool NetworkOccupantFilterBase::IsNetworkOccupant(cISC4Occupant* pOccupant) const
-{
-	bool result = false;
+	void Init();
+	void Shutdown();
 
-	if (pOccupant)
-	{
-		cRZAutoRefCount<cISC4NetworkOccupant> networkOccupant;
+	cISC4OccupantFilter* GetOccupantFilter(FilterType type) const;
 
-		if (pOccupant->QueryInterface(GZIID_cISC4NetworkOccupant, networkOccupant.AsPPVoid()))
-		{
-			result = networkOccupant->HasAnyNetworkFlag(networkFlags);
-		}
-	}
+private:
+	static constexpr size_t kFilterTypeCount = 4;
 
-	return result;
-}
+	std::array<cRZAutoRefCount<cISC4OccupantFilter>, kFilterTypeCount> filters;
+	bool initialized;
+};
@@ -0,0 +1,731 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OccupantFilterProgram.h"
+#include "cISC4ZoneManager.h"
+#include "NetworkTypeFlags.h"
+#include <array>
+
+using ZoneType = cISC4ZoneManager::ZoneType;
+
+namespace
+{
+	constexpr size_t kMaxExpressionLength = 4096;
+	constexpr uint32_t kMaxNestingDepth = 64;
+
+	struct TermName
+	{
+		std::string_view name;
+		OccupantFilterProgram::TestType type;
+		uint32_t mask;
+	};
+
+	constexpr uint32_t NetworkMask(NetworkTypeFlags flags)
+	{
+		return static_cast<uint32_t>(flags);
+	}
+
+	constexpr uint32_t ZoneBit(ZoneType zoneType)
+	{
+		return 1U << static_cast<uint32_t>(zoneType);
+	}
+
+	using TestType = OccupantFilterProgram::TestType;
+
+	constexpr std::array<TermName, 17> kTermNames =
+	{
+		TermName{ "flora", TestType::OccupantType, OccupantFilterProgram::OccupantTypeClassFlora },
+		TermName{ "building", TestType::OccupantType, OccupantFilterProgram::OccupantTypeClassBuilding },
+		TermName{ "prop", TestType::OccupantType, OccupantFilterProgram::OccupantTypeClassProp },
+		TermName{ "network", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::AllTransportationNetworks) },
+		TermName{ "road", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::Road) },
+		TermName{ "rail", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::Rail) },
+		TermName{ "highway", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::Highway) },
+		TermName{ "street", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::Street) },
+		TermName{ "pipe", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::WaterPipe) },
+		TermName{ "power", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::PowerPole) },
+		TermName{ "avenue", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::Avenue) },
+		TermName{ "subway", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::Subway) },
+		TermName{ "lightrail", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::LightRail) },
+		TermName{ "monorail", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::Monorail) },
+		TermName{ "onewayroad", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::OneWayRoad) },
+		TermName{ "dirtroad", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::DirtRoad) },
+		TermName{ "groundhighway", TestType::NetworkFlags, NetworkMask(NetworkTypeFlags::GroundHighway) },
+	};
+
+	struct ZoneName
+	{
+		std::string_view name;
+		uint32_t mask;
+	};
+
+	constexpr std::array<ZoneName, 20> kZoneNames =
+	{
+		ZoneName{ "none", ZoneBit(ZoneType::None) },
+		ZoneName{ "RL", ZoneBit(ZoneType::ResidentialLowDensity) },
+		ZoneName{ "RM", ZoneBit(ZoneType::ResidentialMediumDensity) },
+		ZoneName{ "RH", ZoneBit(ZoneType::ResidentialHighDensity) },
+		ZoneName{ "CL", ZoneBit(ZoneType::CommercialLowDensity) },
+		ZoneName{ "CM", ZoneBit(ZoneType::CommercialMediumDensity) },
+		ZoneName{ "CH", ZoneBit(ZoneType::CommercialHighDensity) },
+		ZoneName{ "agriculture", ZoneBit(ZoneType::Agriculture) },
+		ZoneName{ "IM", ZoneBit(ZoneType::IndustrialMediumDensity) },
+		ZoneName{ "IH", ZoneBit(ZoneType::IndustrialHighDensity) },
+		ZoneName{ "military", ZoneBit(ZoneType::Military) },
+		ZoneName{ "airport", ZoneBit(ZoneType::Airport) },
+		ZoneName{ "seaport", ZoneBit(ZoneType::Seaport) },
+		ZoneName{ "spaceport", ZoneBit(ZoneType::Spaceport) },
+		ZoneName{ "landfill", ZoneBit(ZoneType::Landfill) },
+		ZoneName{ "plopped", ZoneBit(ZoneType::Plopped) },
+		ZoneName
+		{
+			"residential",
+			ZoneBit(ZoneType::ResidentialLowDensity)
+			| ZoneBit(ZoneType::ResidentialMediumDensity)
+			| ZoneBit(ZoneType::ResidentialHighDensity)
+		},
+		ZoneName
+		{
+			"commercial",
+			ZoneBit(ZoneType::CommercialLowDensity)
+			| ZoneBit(ZoneType::CommercialMediumDensity)
+			| ZoneBit(ZoneType::CommercialHighDensity)
+		},
+		ZoneName
+		{
+			"industrial",
+			ZoneBit(ZoneType::Agriculture)
+			| ZoneBit(ZoneType::IndustrialMediumDensity)
+			| ZoneBit(ZoneType::IndustrialHighDensity)
+		},
+		ZoneName
+		{
+			"rci",
+			ZoneBit(ZoneType::ResidentialLowDensity)
+			| ZoneBit(ZoneType::ResidentialMediumDensity)
+			| ZoneBit(ZoneType::ResidentialHighDensity)
+			| ZoneBit(ZoneType::CommercialLowDensity)
+			| ZoneBit(ZoneType::CommercialMediumDensity)
+			| ZoneBit(ZoneType::CommercialHighDensity)
+			| ZoneBit(ZoneType::Agriculture)
+			| ZoneBit(ZoneType::IndustrialMediumDensity)
+			| ZoneBit(ZoneType::IndustrialHighDensity)
+		},
+	};
+
+	bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs)
+	{
+		if (lhs.size() != rhs.size())
+		{
+			return false;
+		}
+
+		for (size_t i = 0; i < lhs.size(); i++)
+		{
+			char a = lhs[i];
+			char b = rhs[i];
+
+			if (a >= 'A' && a <= 'Z')
+			{
+				a = static_cast<char>(a - 'A' + 'a');
+			}
+
+			if (b >= 'A' && b <= 'Z')
+			{
+				b = static_cast<char>(b - 'A' + 'a');
+			}
+
+			if (a != b)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	bool IsIdentifierChar(char c)
+	{
+		return (c >= 'a' && c <= 'z')
+			|| (c >= 'A' && c <= 'Z')
+			|| (c >= '0' && c <= '9')
+			|| c == '_';
+	}
+
+	uint32_t GetAllMaskBits(TestType type)
+	{
+		switch (type)
+		{
+		case TestType::OccupantType:
+			return OccupantFilterProgram::OccupantTypeClassAll;
+		case TestType::LotZone:
+			return OccupantFilterProgram::kAllLotZoneBits;
+		case TestType::NetworkFlags:
+		default:
+			return 0xFFFFFFFF;
+		}
+	}
+}
+
+struct OccupantFilterProgram::Node
+{
+	enum class Kind : uint8_t
+	{
+		Constant,
+		Test,
+		Not,
+		And,
+		Or,
+	};
+
+	Kind kind;
+	TestType testType;
+	// The test mask, or 1 for a true constant and 0 for a false constant.
+	uint32_t mask;
+	uint32_t left;
+	uint32_t right;
+};
+
+// A recursive descent parser for the expression grammar:
+//
+// expression := and-term { OR and-term }
+// and-term   := unary { AND unary }
+// unary      := NOT unary | '(' expression ')' | term
+// term       := flora | building | prop | network | <network name> | lot
+//             | lot zone in '{' <zone name> { ',' <zone name> } '}'
+//
+// The keywords and names are case-insensitive. Constant terms and adjacent terms of the
+// same type are folded as the nodes are created.
+class OccupantFilterProgram::Parser
+{
+public:
+	Parser(std::string_view text, std::vector<Node>& nodes)
+		: text(text), position(0), depth(0), nodes(nodes)
+	{
+	}
+
+	bool Parse(uint32_t& root, std::string& error)
+	{
+		if (!ParseOr(root))
+		{
+			error = this->error;
+			return false;
+		}
+
+		SkipWhitespace();
+
+		if (position < text.size())
+		{
+			SetError("Unexpected text");
+			error = this->error;
+			return false;
+		}
+
+		return true;
+	}
+
+private:
+	bool ParseOr(uint32_t& node)
+	{
+		if (!ParseAnd(node))
+		{
+			return false;
+		}
+
+		while (TryConsumeKeyword("or"))
+		{
+			uint32_t right = 0;
+
+			if (!ParseAnd(right))
+			{
+				return false;
+			}
+
+			node = MakeOr(node, right);
+		}
+
+		return true;
+	}
+
+	bool ParseAnd(uint32_t& node)
+	{
+		if (!ParseUnary(node))
+		{
+			return false;
+		}
+
+		while (TryConsumeKeyword("and"))
+		{
+			uint32_t right = 0;
+
+			if (!ParseUnary(right))
+			{
+				return false;
+			}
+
+			node = MakeAnd(node, right);
+		}
+
+		return true;
+	}
+
+	bool ParseUnary(uint32_t& node)
+	{
+		if (++depth > kMaxNestingDepth)
+		{
+			SetError("The expression is nested too deeply");
+			return false;
+		}
+
+		bool result = false;
+
+		if (TryConsumeKeyword("not"))
+		{
+			uint32_t operand = 0;
+
+			if (ParseUnary(operand))
+			{
+				node = MakeNot(operand);
+				result = true;
+			}
+		}
+		else if (TryConsumeChar('('))
+		{
+			if (ParseOr(node))
+			{
+				if (TryConsumeChar(')'))
+				{
+					result = true;
+				}
+				else
+				{
+					SetError("Expected ')'");
+				}
+			}
+		}
+		else
+		{
+			result = ParseTerm(node);
+		}
+
+		depth--;
+		return result;
+	}
+
+	bool ParseTerm(uint32_t& node)
+	{
+		const std::string_view name = ReadIdentifier();
+
+		if (name.empty())
+		{
+			SetError("Expected a filter term");
+			return false;
+		}
+
+		if (EqualsIgnoreCase(name, "lot"))
+		{
+			uint32_t zoneMask = kAllLotZoneBits & ~kNoLotZoneBit;
+
+			if (TryConsumeKeyword("zone"))
+			{
+				if (!TryConsumeKeyword("in") || !TryConsumeChar('{'))
+				{
+					SetError("Expected 'in {' after 'lot zone'");
+					return false;
+				}
+
+				if (!ParseZoneList(zoneMask))
+				{
+					return false;
+				}
+			}
+
+			node = MakeTest(TestType::LotZone, zoneMask);
+			return true;
+		}
+
+		for (const TermName& term : kTermNames)
+		{
+			if (EqualsIgnoreCase(name, term.name))
+			{
+				node = MakeTest(term.type, term.mask);
+				return true;
+			}
+		}
+
+		SetError("Unknown filter term '" + std::string(name) + "'");
+		return false;
+	}
+
+	bool ParseZoneList(uint32_t& zoneMask)
+	{
+		zoneMask = 0;
+
+		do
+		{
+			const std::string_view name = ReadIdentifier();
+			bool found = false;
+
+			for (const ZoneName& zone : kZoneNames)
+			{
+				if (EqualsIgnoreCase(name, zone.name))
+				{
+					zoneMask |= zone.mask;
+					found = true;
+					break;
+				}
+			}
+
+			if (!found)
+			{
+				SetError("Unknown zone name '" + std::string(name) + "'");
+				return false;
+			}
+
+		} while (TryConsumeChar(','));
+
+		if (!TryConsumeChar('}'))
+		{
+			SetError("Expected '}'");
+			return false;
+		}
+
+		return true;
+	}
+
+	uint32_t AddNode(const Node& node)
+	{
+		nodes.push_back(node);
+		return static_cast<uint32_t>(nodes.size() - 1);
+	}
+
+	uint32_t MakeConstant(bool value)
+	{
+		return AddNode(Node{ Node::Kind::Constant, TestType::OccupantType, value ? 1U : 0U, 0, 0 });
+	}
+
+	uint32_t MakeTest(TestType type, uint32_t mask)
+	{
+		mask &= GetAllMaskBits(type);
+
+		if (mask == 0)
+		{
+			return MakeConstant(false);
+		}
+		else if (type != TestType::NetworkFlags && mask == GetAllMaskBits(type))
+		{
+			return MakeConstant(true);
+		}
+
+		return AddNode(Node{ Node::Kind::Test, type, mask, 0, 0 });
+	}
+
+	bool IsFoldableTest(const Node& node) const
+	{
+		// A network test passes if the occupant has any of the flags, so only
+		// the occupant type and lot zone tests can be inverted or intersected.
+		return node.kind == Node::Kind::Test && node.testType != TestType::NetworkFlags;
+	}
+
+	uint32_t MakeNot(uint32_t operand)
+	{
+		const Node node = nodes[operand];
+
+		if (node.kind == Node::Kind::Constant)
+		{
+			return MakeConstant(node.mask == 0);
+		}
+		else if (node.kind == Node::Kind::Not)
+		{
+			return node.left;
+		}
+		else if (IsFoldableTest(node))
+		{
+			return MakeTest(node.testType, ~node.mask);
+		}
+
+		return AddNode(Node{ Node::Kind::Not, TestType::OccupantType, 0, operand, 0 });
+	}
+
+	uint32_t MakeAnd(uint32_t left, uint32_t right)
+	{
+		const Node lhs = nodes[left];
+		const Node rhs = nodes[right];
+
+		if (lhs.kind == Node::Kind::Constant)
+		{
+			return lhs.mask != 0 ? right : left;
+		}
+		else if (rhs.kind == Node::Kind::Constant)
+		{
+			return rhs.mask != 0 ? left : right;
+		}
+		else if (IsFoldableTest(lhs) && IsFoldableTest(rhs) && lhs.testType == rhs.testType)
+		{
+			return MakeTest(lhs.testType, lhs.mask & rhs.mask);
+		}
+
+		return AddNode(Node{ Node::Kind::And, TestType::OccupantType, 0, left, right });
+	}
+
+	uint32_t MakeOr(uint32_t left, uint32_t right)
+	{
+		const Node lhs = nodes[left];
+		const Node rhs = nodes[right];
+
+		if (lhs.kind == Node::Kind::Constant)
+		{
+			return lhs.mask != 0 ? left : right;
+		}
+		else if (rhs.kind == Node::Kind::Constant)
+		{
+			return rhs.mask != 0 ? right : left;
+		}
+		else if (lhs.kind == Node::Kind::Test && rhs.kind == Node::Kind::Test && lhs.testType == rhs.testType)
+		{
+			return MakeTest(lhs.testType, lhs.mask | rhs.mask);
+		}
+
+		return AddNode(Node{ Node::Kind::Or, TestType::OccupantType, 0, left, right });
+	}
+
+	void SkipWhitespace()
+	{
+		while (position < text.size()
+			&& (text[position] == ' ' || text[position] == '\t' || text[position] == '\r' || text[position] == '\n'))
+		{
+			position++;
+		}
+	}
+
+	std::string_view ReadIdentifier()
+	{
+		SkipWhitespace();
+
+		const size_t start = position;
+
+		while (position < text.size() && IsIdentifierChar(text[position]))
+		{
+			position++;
+		}
+
+		return text.substr(start, position - start);
+	}
+
+	bool TryConsumeKeyword(std::string_view keyword)
+	{
+		const size_t start = position;
+
+		if (EqualsIgnoreCase(ReadIdentifier(), keyword))
+		{
+			return true;
+		}
+
+		position = start;
+		return false;
+	}
+
+	bool TryConsumeChar(char c)
+	{
+		SkipWhitespace();
+
+		if (position < text.size() && text[position] == c)
+		{
+			position++;
+			return true;
+		}
+
+		return false;
+	}
+
+	void SetError(const std::string& message)
+	{
+		if (error.empty())
+		{
+			error = message + " at position " + std::to_string(position) + '.';
+		}
+	}
+
+	std::string_view text;
+	size_t position;
+	uint32_t depth;
+	std::vector<Node>& nodes;
+	std::string error;
+};
+
+OccupantFilterProgram::OccupantFilterProgram()
+	: instructions(),
+	  entryPoint(kReject),
+	  includedTypeClasses(0),
+	  acceptedTypeClasses(0)
+{
+}
+
+bool OccupantFilterProgram::Compile(std::string_view expression, std::string& error)
+{
+	instructions.clear();
+	entryPoint = kReject;
+	includedTypeClasses = 0;
+	acceptedTypeClasses = 0;
+
+	if (expression.size() > kMaxExpressionLength)
+	{
+		error = "The expression is longer than " + std::to_string(kMaxExpressionLength) + " characters.";
+		return false;
+	}
+
+	std::vector<Node> nodes;
+	uint32_t root = 0;
+
+	Parser parser(expression, nodes);
+
+	if (!parser.Parse(root, error))
+	{
+		return false;
+	}
+
+	entryPoint = Emit(nodes, root, kAccept, kReject);
+	UpdateTypeClasses();
+
+	return true;
+}
+
+void OccupantFilterProgram::Negate()
+{
+	auto negate = [](uint16_t target)
+	{
+		return target == kAccept ? kReject : target == kReject ? kAccept : target;
+	};
+
+	for (Instruction& instruction : instructions)
+	{
+		instruction.ifTrue = negate(instruction.ifTrue);
+		instruction.ifFalse = negate(instruction.ifFalse);
+	}
+
+	entryPoint = negate(entryPoint);
+	UpdateTypeClasses();
+}
+
+uint16_t OccupantFilterProgram::GetEntryPoint() const
+{
+	return entryPoint;
+}
+
+const std::vector<OccupantFilterProgram::Instruction>& OccupantFilterProgram::GetInstructions() const
+{
+	return instructions;
+}
+
+uint32_t OccupantFilterProgram::GetIncludedTypeClasses() const
+{
+	return includedTypeClasses;
+}
+
+uint32_t OccupantFilterProgram::GetAcceptedTypeClasses() const
+{
+	return acceptedTypeClasses;
+}
+
+uint16_t OccupantFilterProgram::Emit(const std::vector<Node>& nodes, uint32_t nodeIndex, uint16_t ifTrue, uint16_t ifFalse)
+{
+	const Node& node = nodes[nodeIndex];
+
+	// The right operand is emitted first so that every branch target has a lower
+	// index than the instruction that uses it.
+	switch (node.kind)
+	{
+	case Node::Kind::Constant:
+		return node.mask != 0 ? ifTrue : ifFalse;
+	case Node::Kind::Not:
+		return Emit(nodes, node.left, ifFalse, ifTrue);
+	case Node::Kind::And:
+		return Emit(nodes, node.left, Emit(nodes, node.right, ifTrue, ifFalse), ifFalse);
+	case Node::Kind::Or:
+		return Emit(nodes, node.left, ifTrue, Emit(nodes, node.right, ifTrue, ifFalse));
+	case Node::Kind::Test:
+	default:
+		instructions.push_back(Instruction{ node.testType, node.mask, ifTrue, ifFalse });
+		return static_cast<uint16_t>(instructions.size() - 1);
+	}
+}
+
+void OccupantFilterProgram::UpdateTypeClasses()
+{
+	includedTypeClasses = 0;
+	acceptedTypeClasses = 0;
+
+	// Every branch target has a lower index than the instruction that uses it, so the
+	// possible results of each instruction are found in a single forward pass.
+	enum ResultFlags : uint8_t
+	{
+		ResultFlagReject = 1 << 0,
+		ResultFlagAccept = 1 << 1,
+	};
+
+	std::vector<uint8_t> results(instructions.size());
+
+	auto getResults = [&](uint16_t target) -> uint8_t
+	{
+		return target == kAccept
+			? static_cast<uint8_t>(ResultFlagAccept)
+			: target == kReject ? static_cast<uint8_t>(ResultFlagReject) : results[target];
+	};
+
+	for (uint32_t typeClass = 1; typeClass <= OccupantTypeClassAll; typeClass <<= 1)
+	{
+		// Flora, buildings and props never have network flags.
+		const bool hasNetworkFlags = (typeClass & (OccupantTypeClassNetwork | OccupantTypeClassOther)) != 0;
+
+		for (size_t i = 0; i < instructions.size(); i++)
+		{
+			const Instruction& instruction = instructions[i];
+
+			switch (instruction.type)
+			{
+			case TestType::OccupantType:
+				results[i] = getResults((instruction.mask & typeClass) != 0 ? instruction.ifTrue : instruction.ifFalse);
+				break;
+			case TestType::NetworkFlags:
+				results[i] = hasNetworkFlags
+					? getResults(instruction.ifTrue) | getResults(instruction.ifFalse)
+					: getResults(instruction.ifFalse);
+				break;
+			case TestType::LotZone:
+			default:
+				results[i] = getResults(instruction.ifTrue) | getResults(instruction.ifFalse);
+				break;
+			}
+		}
+
+		const uint8_t entryResults = getResults(entryPoint);
+
+		if ((entryResults & ResultFlagAccept) != 0)
+		{
+			includedTypeClasses |= typeClass;
+
+			if ((entryResults & ResultFlagReject) == 0)
+			{
+				acceptedTypeClasses |= typeClass;
+			}
+		}
+	}
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "OccupantTypes.h"
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// An occupant filter that is compiled from a text expression, for example
+// "flora OR (network AND NOT highway)" or "lot zone in {RL, RM}".
+//
+// The expression is compiled into a flat list of tests where each test branches to the
+// next test or to the result, so an occupant's network flags and lot are only looked up
+// when the result depends on them. Adjacent occupant type and lot zone terms are folded
+// into a single test with a precomputed mask.
+class OccupantFilterProgram
+{
+public:
+	enum class TestType : uint8_t
+	{
+		// The mask is a set of OccupantTypeClass values.
+		OccupantType,
+		// The mask is a set of NetworkTypeFlags values, the test passes if the occupant
+		// has any of them.
+		NetworkFlags,
+		// The mask has a bit for each cISC4ZoneManager::ZoneType value and the
+		// kNoLotZoneBit for occupants that are not on a lot.
+		LotZone,
+	};
+
+	enum OccupantTypeClass : uint32_t
+	{
+		OccupantTypeClassFlora = 1 << 0,
+		OccupantTypeClassBuilding = 1 << 1,
+		OccupantTypeClassProp = 1 << 2,
+		OccupantTypeClassNetwork = 1 << 3,
+		OccupantTypeClassOther = 1 << 4,
+		OccupantTypeClassAll = (1 << 5) - 1,
+	};
+
+	static constexpr uint32_t kNoLotZoneBit = 1 << 16;
+	static constexpr uint32_t kAllLotZoneBits = (1 << 17) - 1;
+
+	// The branch targets that end the program.
+	static constexpr uint16_t kReject = 0xFFFE;
+	static constexpr uint16_t kAccept = 0xFFFF;
+
+	struct Instruction
+	{
+		TestType type;
+		uint32_t mask;
+		uint16_t ifTrue;
+		uint16_t ifFalse;
+	};
+
+	OccupantFilterProgram();
+
+	// Compiles the expression, returns false and sets the error message if it is invalid.
+	bool Compile(std::string_view expression, std::string& error);
+
+	// Inverts the result of the program.
+	void Negate();
+
+	uint16_t GetEntryPoint() const;
+	const std::vector<Instruction>& GetInstructions() const;
+
+	// Gets the occupant type classes that the program can include, occupants of the
+	// other classes are rejected without running the program.
+	uint32_t GetIncludedTypeClasses() const;
+
+	// Gets the occupant type classes that the program always includes, occupants of
+	// these classes are accepted without running the program.
+	uint32_t GetAcceptedTypeClasses() const;
+
+	// Defined in the header because the filter calls it for every occupant.
+	static uint32_t GetOccupantTypeClass(uint32_t type)
+	{
+		switch (type)
+		{
+		case kFloraOccupantType:
+			return OccupantTypeClassFlora;
+		case kBuildingOccupantType:
+			return OccupantTypeClassBuilding;
+		case kPropOccupantType:
+			return OccupantTypeClassProp;
+		case kNetworkOccupantType:
+			return OccupantTypeClassNetwork;
+		default:
+			return OccupantTypeClassOther;
+		}
+	}
+
+private:
+	struct Node;
+	class Parser;
+
+	uint16_t Emit(const std::vector<Node>& nodes, uint32_t nodeIndex, uint16_t ifTrue, uint16_t ifFalse);
+	void UpdateTypeClasses();
+
+	std::vector<Instruction> instructions;
+	uint16_t entryPoint;
+	uint32_t includedTypeClasses;
+	uint32_t acceptedTypeClasses;
+};
@@ -0,0 +1,166 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OccupantPredicates.h"
+#include "cISC4Lot.h"
+#include "cISC4LotManager.h"
+#include "cISC4NetworkOccupant.h"
+#include "cISC4Occupant.h"
+#include "cRZAutoRefCount.h"
+#include "GlobalCityPointers.h"
+
+using Memo = OccupantClassificationMemo;
+using ZoneType = cISC4ZoneManager::ZoneType;
+
+OccupantPredicateContext::OccupantPredicateContext(
+	cISC4Occupant* pOccupant,
+	OccupantClassificationMemo* pClassificationMemo,
+	LotZoneTypeCache& lotZoneTypes)
+	: pOccupant(pOccupant),
+	  type(pOccupant ? pOccupant->GetType() : 0),
+	  pClassificationMemo(pClassificationMemo),
+	  pClassification(nullptr),
+	  lotZoneTypes(lotZoneTypes)
+{
+}
+
+uint32_t OccupantPredicateContext::GetType() const
+{
+	return type;
+}
+
+bool OccupantPredicateContext::HasAnyNetworkFlag(NetworkTypeFlags networkTypeFlags)
+{
+	bool result = false;
+
+	// The occupant type check avoids the QueryInterface call and its AddRef/Release for the
+	// flora, building and prop occupants that make up most of a typical selection.
+	if (pOccupant && IsPossibleNetworkOccupantType(type))
+	{
+		const uint32_t networkFlags = static_cast<uint32_t>(networkTypeFlags);
+
+		Memo::Classification* pMemoClassification = GetClassification();
+
+		if (pMemoClassification)
+		{
+			if ((pMemoClassification->flags & Memo::ClassificationFlagNetworkKnown) != 0
+				&& pMemoClassification->networkFlags == networkFlags)
+			{
+				result = (pMemoClassification->flags & Memo::ClassificationFlagNetwork) != 0;
+			}
+			else
+			{
+				result = QueryHasAnyNetworkFlag(networkFlags);
+
+				pMemoClassification->networkFlags = networkFlags;
+				pMemoClassification->flags &= ~(Memo::ClassificationFlagNetworkKnown | Memo::ClassificationFlagNetwork);
+				pMemoClassification->flags |= Memo::ClassificationFlagNetworkKnown;
+
+				if (result)
+				{
+					pMemoClassification->flags |= Memo::ClassificationFlagNetwork;
+				}
+			}
+		}
+		else
+		{
+			result = QueryHasAnyNetworkFlag(networkFlags);
+		}
+	}
+
+	return result;
+}
+
+bool OccupantPredicateContext::TryGetLotZoneType(ZoneType& zoneType)
+{
+	bool result = false;
+
+	if (pOccupant && spLotManager)
+	{
+		Memo::Classification* pMemoClassification = GetClassification();
+
+		if (pMemoClassification)
+		{
+			if ((pMemoClassification->flags & Memo::ClassificationFlagLotKnown) == 0)
+			{
+				pMemoClassification->flags |= Memo::ClassificationFlagLotKnown;
+
+				pMemoClassification->pLot = QueryLot(pMemoClassification->zoneType);
+
+				if (pMemoClassification->pLot)
+				{
+					pMemoClassification->flags |= Memo::ClassificationFlagLot;
+				}
+			}
+
+			if ((pMemoClassification->flags & Memo::ClassificationFlagLot) != 0)
+			{
+				zoneType = pMemoClassification->zoneType;
+				result = true;
+			}
+		}
+		else
+		{
+			result = QueryLot(zoneType) != nullptr;
+		}
+	}
+
+	return result;
+}
+
+Memo::Classification* OccupantPredicateContext::GetClassification()
+{
+	// The classification is looked up once and shared by all predicates in the chain.
+	if (!pClassification && pClassificationMemo)
+	{
+		pClassification = &pClassificationMemo->Get(pOccupant);
+	}
+
+	return pClassification;
+}
+
+bool OccupantPredicateContext::QueryHasAnyNetworkFlag(uint32_t networkFlags) const
+{
+	bool result = false;
+
+	cRZAutoRefCount<cISC4NetworkOccupant> networkOccupant;
+
+	if (pOccupant->QueryInterface(GZIID_cISC4NetworkOccupant, networkOccupant.AsPPVoid()))
+	{
+		result = networkOccupant->HasAnyNetworkFlag(networkFlags);
+	}
+
+	return result;
+}
+
+cISC4Lot* OccupantPredicateContext::QueryLot(ZoneType& zoneType)
+{
+	cISC4Lot* pLot = spLotManager->GetOccupantLot(pOccupant);
+
+	if (pLot && !lotZoneTypes.TryGet(pLot, zoneType))
+	{
+		zoneType = pLot->GetZoneType();
+		lotZoneTypes.Add(pLot, zoneType);
+	}
+
+	return pLot;
+}
@@ -0,0 +1,210 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "cISC4ZoneManager.h"
+#include "LotZoneTypeCache.h"
+#include "NetworkTypeFlags.h"
+#include "OccupantClassificationMemo.h"
+#include "OccupantTypes.h"
+#include <cstdint>
+
+class cISC4Occupant;
+
+// Occupant predicates are policy classes that are combined at compile time with the
+// And, Or and Not templates, PredicateOccupantFilter folds a predicate chain into a single
+// cISC4OccupantFilter implementation.
+//
+// Each predicate provides:
+//   static bool Evaluate(OccupantPredicateContext& context)
+//   static constexpr PredicateResult EvaluateType(uint32_t type)
+//   static constexpr bool kTypeOnly
+//
+// EvaluateType is used for cISC4OccupantFilter::IsOccupantTypeIncluded, it returns Unknown
+// when the occupant type alone does not decide the result.
+// kTypeOnly is true when EvaluateType never returns Unknown.
+
+enum class PredicateResult : uint8_t
+{
+	False = 0,
+	True,
+	Unknown
+};
+
+constexpr PredicateResult operator!(PredicateResult value)
+{
+	return value == PredicateResult::Unknown ? PredicateResult::Unknown
+		: value == PredicateResult::True ? PredicateResult::False
+		: PredicateResult::True;
+}
+
+constexpr PredicateResult operator&&(PredicateResult lhs, PredicateResult rhs)
+{
+	return lhs == PredicateResult::False || rhs == PredicateResult::False ? PredicateResult::False
+		: lhs == PredicateResult::True && rhs == PredicateResult::True ? PredicateResult::True
+		: PredicateResult::Unknown;
+}
+
+constexpr PredicateResult operator||(PredicateResult lhs, PredicateResult rhs)
+{
+	return lhs == PredicateResult::True || rhs == PredicateResult::True ? PredicateResult::True
+		: lhs == PredicateResult::False && rhs == PredicateResult::False ? PredicateResult::False
+		: PredicateResult::Unknown;
+}
+
+// The occupant that the predicates are evaluated for, the values that require a call into
+// the game are queried on first use and shared by all predicates in the chain.
+class OccupantPredicateContext
+{
+public:
+	// The classification memo is optional, the lot zone type cache is owned by the filter.
+	OccupantPredicateContext(
+		cISC4Occupant* pOccupant,
+		OccupantClassificationMemo* pClassificationMemo,
+		LotZoneTypeCache& lotZoneTypes);
+
+	uint32_t GetType() const;
+
+	bool HasAnyNetworkFlag(NetworkTypeFlags networkFlags);
+
+	// Gets the zone type of the occupant's lot, returns false if the occupant is not on a lot.
+	bool TryGetLotZoneType(cISC4ZoneManager::ZoneType& zoneType);
+
+private:
+	OccupantClassificationMemo::Classification* GetClassification();
+	bool QueryHasAnyNetworkFlag(uint32_t networkFlags) const;
+	// Gets the occupant's lot and its zone type, returns nullptr if the occupant is not on a lot.
+	cISC4Lot* QueryLot(cISC4ZoneManager::ZoneType& zoneType);
+
+	cISC4Occupant* pOccupant;
+	uint32_t type;
+	OccupantClassificationMemo* pClassificationMemo;
+	OccupantClassificationMemo::Classification* pClassification;
+	LotZoneTypeCache& lotZoneTypes;
+};
+
+template<uint32_t OccupantType>
+struct IsOccupantType
+{
+	static constexpr bool kTypeOnly = true;
+
+	static constexpr PredicateResult EvaluateType(uint32_t type)
+	{
+		return type == OccupantType ? PredicateResult::True : PredicateResult::False;
+	}
+
+	static bool Evaluate(OccupantPredicateContext& context)
+	{
+		return context.GetType() == OccupantType;
+	}
+};
+
+using IsFloraType = IsOccupantType<kFloraOccupantType>;
+
+template<NetworkTypeFlags NetworkFlags>
+struct HasNetworkFlags
+{
+	static constexpr bool kTypeOnly = false;
+
+	static constexpr PredicateResult EvaluateType(uint32_t type)
+	{
+		return IsPossibleNetworkOccupantType(type) ? PredicateResult::Unknown : PredicateResult::False;
+	}
+
+	static bool Evaluate(OccupantPredicateContext& context)
+	{
+		return context.HasAnyNetworkFlag(NetworkFlags);
+	}
+};
+
+template<cISC4ZoneManager::ZoneType... ZoneTypes>
+struct LotZoneIn
+{
+	static constexpr bool kTypeOnly = false;
+
+	static constexpr PredicateResult EvaluateType(uint32_t)
+	{
+		return PredicateResult::Unknown;
+	}
+
+	static bool Evaluate(OccupantPredicateContext& context)
+	{
+		constexpr uint32_t kZoneMask = ((1U << static_cast<uint32_t>(ZoneTypes)) | ... | 0U);
+
+		cISC4ZoneManager::ZoneType zoneType = cISC4ZoneManager::ZoneType::None;
+
+		return context.TryGetLotZoneType(zoneType)
+			&& ((kZoneMask >> static_cast<uint32_t>(zoneType)) & 1) != 0;
+	}
+};
+
+template<class... Predicates>
+struct And
+{
+	static_assert(sizeof...(Predicates) > 0, "And requires at least one predicate.");
+
+	static constexpr bool kTypeOnly = (Predicates::kTypeOnly && ...);
+
+	static constexpr PredicateResult EvaluateType(uint32_t type)
+	{
+		return (Predicates::EvaluateType(type) && ...);
+	}
+
+	static bool Evaluate(OccupantPredicateContext& context)
+	{
+		return (Predicates::Evaluate(context) && ...);
+	}
+};
+
+template<class... Predicates>
+struct Or
+{
+	static_assert(sizeof...(Predicates) > 0, "Or requires at least one predicate.");
+
+	static constexpr bool kTypeOnly = (Predicates::kTypeOnly && ...);
+
+	static constexpr PredicateResult EvaluateType(uint32_t type)
+	{
+		return (Predicates::EvaluateType(type) || ...);
+	}
+
+	static bool Evaluate(OccupantPredicateContext& context)
+	{
+		return (Predicates::Evaluate(context) || ...);
+	}
+};
+
+template<class Predicate>
+struct Not
+{
+	static constexpr bool kTypeOnly = Predicate::kTypeOnly;
+
+	static constexpr PredicateResult EvaluateType(uint32_t type)
+	{
+		return !Predicate::EvaluateType(type);
+	}
+
+	static bool Evaluate(OccupantPredicateContext& context)
+	{
+		return !Predicate::Evaluate(context);
+	}
+};
@@ -0,0 +1,153 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "OccupantSet.h"
+#include <algorithm>
+
+namespace
+{
+	constexpr uint32_t kInitialIndexBits = 6;
+}
+
+OccupantSet::OccupantSet()
+	: slots(static_cast<size_t>(1) << kInitialIndexBits, nullptr),
+	  indexBits(kInitialIndexBits),
+	  count(0)
+{
+}
+
+bool OccupantSet::Insert(const cISC4Occupant* pOccupant)
+{
+	if (!pOccupant)
+	{
+		return false;
+	}
+
+	// The table is kept at most half full so that the probe sequences stay short.
+	if ((count + 1) * 2 > slots.size())
+	{
+		Grow();
+	}
+
+	const cISC4Occupant*& slot = slots[GetSlotIndex(pOccupant)];
+
+	if (slot)
+	{
+		return false;
+	}
+
+	slot = pOccupant;
+	count++;
+	return true;
+}
+
+bool OccupantSet::Contains(const cISC4Occupant* pOccupant) const
+{
+	return pOccupant && slots[GetSlotIndex(pOccupant)] == pOccupant;
+}
+
+bool OccupantSet::Remove(const cISC4Occupant* pOccupant)
+{
+	if (!pOccupant)
+	{
+		return false;
+	}
+
+	size_t index = GetSlotIndex(pOccupant);
+
+	if (slots[index] != pOccupant)
+	{
+		return false;
+	}
+
+	const size_t mask = slots.size() - 1;
+
+	// Move the later occupants of the probe sequence back into the empty slot, so that the
+	// searches that passed the removed occupant still reach them.
+	for (size_t next = (index + 1) & mask; slots[next]; next = (next + 1) & mask)
+	{
+		const size_t home = GetHomeIndex(slots[next]);
+
+		if (((next - home) & mask) >= ((next - index) & mask))
+		{
+			slots[index] = slots[next];
+			index = next;
+		}
+	}
+
+	slots[index] = nullptr;
+	count--;
+	return true;
+}
+
+void OccupantSet::Clear()
+{
+	if (count > 0)
+	{
+		std::fill(slots.begin(), slots.end(), nullptr);
+		count = 0;
+	}
+}
+
+size_t OccupantSet::GetCount() const
+{
+	return count;
+}
+
+size_t OccupantSet::GetHomeIndex(const cISC4Occupant* pOccupant) const
+{
+	// Fibonacci hashing, the high bits of the product are used as the starting index.
+	const uint64_t hash = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pOccupant)) * 0x9E3779B97F4A7C15ull;
+
+	return static_cast<size_t>(hash >> (64 - indexBits));
+}
+
+size_t OccupantSet::GetSlotIndex(const cISC4Occupant* pOccupant) const
+{
+	const size_t mask = slots.size() - 1;
+
+	size_t index = GetHomeIndex(pOccupant);
+
+	// Linear probing, the search ends at the occupant's slot or the first empty slot.
+	while (slots[index] && slots[index] != pOccupant)
+	{
+		index = (index + 1) & mask;
+	}
+
+	return index;
+}
+
+void OccupantSet::Grow()
+{
+	std::vector<const cISC4Occupant*> oldSlots(static_cast<size_t>(1) << (indexBits + 1), nullptr);
+
+	oldSlots.swap(slots);
+	indexBits++;
+
+	for (const cISC4Occupant* pOccupant : oldSlots)
+	{
+		if (pOccupant)
+		{
+			slots[GetSlotIndex(pOccupant)] = pOccupant;
+		}
+	}
+}
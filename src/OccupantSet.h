@@ -0,0 +1,57 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class cISC4Occupant;
+
+// A small open-addressing hash set of occupants.
+//
+// The table keeps its storage when it is cleared, so a set that is refilled for each
+// demolition does not allocate once it has grown to the selection size.
+class OccupantSet
+{
+public:
+	OccupantSet();
+
+	// Returns false if the occupant is already in the set.
+	bool Insert(const cISC4Occupant* pOccupant);
+	bool Contains(const cISC4Occupant* pOccupant) const;
+	// Returns false if the occupant is not in the set.
+	bool Remove(const cISC4Occupant* pOccupant);
+
+	void Clear();
+
+	size_t GetCount() const;
+
+private:
+	size_t GetHomeIndex(const cISC4Occupant* pOccupant) const;
+	size_t GetSlotIndex(const cISC4Occupant* pOccupant) const;
+	void Grow();
+
+	std::vector<const cISC4Occupant*> slots;
+	uint32_t indexBits;
+	size_t count;
+};
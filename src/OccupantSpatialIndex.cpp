@@ -0,0 +1,166 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "OccupantSpatialIndex.h"
+#include <algorithm>
+
+OccupantSpatialIndex::OccupantSpatialIndex()
+	: cellCountX(0),
+	  cellCountZ(0),
+	  cells(),
+	  categoryCells(),
+	  scratch(),
+	  emptyCell()
+{
+}
+
+void OccupantSpatialIndex::Reset(int32_t cellCountX, int32_t cellCountZ)
+{
+	this->cellCountX = std::max(cellCountX, 0);
+	this->cellCountZ = std::max(cellCountZ, 0);
+
+	cells.clear();
+	cells.resize(static_cast<size_t>(this->cellCountX) * static_cast<size_t>(this->cellCountZ));
+
+	for (BitsetCellRegion& region : categoryCells)
+	{
+		region.Reset(0, 0, this->cellCountX - 1, this->cellCountZ - 1);
+	}
+}
+
+void OccupantSpatialIndex::Insert(const SC4Rect<int32_t>& cellBounds, const Entry& entry)
+{
+	SC4Rect<int32_t> clipped;
+
+	if (!ClipToCity(cellBounds, clipped))
+	{
+		return;
+	}
+
+	const size_t categoryIndex = static_cast<size_t>(entry.category);
+	BitsetCellRegion& categoryRegion = categoryCells[categoryIndex];
+
+	Entry cellEntry = entry;
+	cellEntry.coversMultipleCells = clipped.topLeftX != clipped.bottomRightX || clipped.topLeftY != clipped.bottomRightY;
+
+	for (int32_t z = clipped.topLeftY; z <= clipped.bottomRightY; z++)
+	{
+		for (int32_t x = clipped.topLeftX; x <= clipped.bottomRightX; x++)
+		{
+			Cell& cell = cells[(static_cast<size_t>(z) * static_cast<size_t>(cellCountX)) + static_cast<size_t>(x)];
+
+			cell.occupants.push_back(cellEntry);
+
+			if (cell.categoryCounts[categoryIndex]++ == 0)
+			{
+				categoryRegion.SetValue(static_cast<uint32_t>(x), static_cast<uint32_t>(z), true);
+			}
+		}
+	}
+}
+
+void OccupantSpatialIndex::Remove(const SC4Rect<int32_t>& cellBounds, cISC4Occupant* pOccupant)
+{
+	SC4Rect<int32_t> clipped;
+
+	if (!ClipToCity(cellBounds, clipped))
+	{
+		return;
+	}
+
+	for (int32_t z = clipped.topLeftY; z <= clipped.bottomRightY; z++)
+	{
+		for (int32_t x = clipped.topLeftX; x <= clipped.bottomRightX; x++)
+		{
+			Cell& cell = cells[(static_cast<size_t>(z) * static_cast<size_t>(cellCountX)) + static_cast<size_t>(x)];
+
+			auto it = std::find_if(
+				cell.occupants.begin(),
+				cell.occupants.end(),
+				[pOccupant](const Entry& entry) { return entry.pOccupant == pOccupant; });
+
+			if (it != cell.occupants.end())
+			{
+				const size_t categoryIndex = static_cast<size_t>(it->category);
+
+				if (--cell.categoryCounts[categoryIndex] == 0)
+				{
+					categoryCells[categoryIndex].SetValue(static_cast<uint32_t>(x), static_cast<uint32_t>(z), false);
+				}
+
+				// The bucket order is not significant.
+				*it = cell.occupants.back();
+				cell.occupants.pop_back();
+			}
+		}
+	}
+}
+
+const std::vector<OccupantSpatialIndex::Entry>& OccupantSpatialIndex::GetCellOccupants(int32_t x, int32_t z) const
+{
+	if (x < 0 || x >= cellCountX || z < 0 || z >= cellCountZ)
+	{
+		return emptyCell;
+	}
+
+	return cells[(static_cast<size_t>(z) * static_cast<size_t>(cellCountX)) + static_cast<size_t>(x)].occupants;
+}
+
+bool OccupantSpatialIndex::HasOccupants(const SC4Rect<int32_t>& rect, uint32_t categoryFlags) const
+{
+	for (size_t i = 0; i < kOccupantCategoryCount; i++)
+	{
+		if ((categoryFlags & GetOccupantCategoryFlag(static_cast<OccupantCategory>(i))) != 0
+			&& categoryCells[i].HasSetCells(rect))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void OccupantSpatialIndex::RemoveCellsWithoutOccupants(BitsetCellRegion& region, uint32_t categoryFlags)
+{
+	const SC4Rect<int32_t>& bounds = region.GetBounds();
+
+	scratch.Reset(bounds.topLeftX, bounds.topLeftY, bounds.bottomRightX, bounds.bottomRightY);
+
+	for (size_t i = 0; i < kOccupantCategoryCount; i++)
+	{
+		if ((categoryFlags & GetOccupantCategoryFlag(static_cast<OccupantCategory>(i))) != 0)
+		{
+			scratch.Unite(categoryCells[i]);
+		}
+	}
+
+	region.Intersect(scratch);
+}
+
+bool OccupantSpatialIndex::ClipToCity(const SC4Rect<int32_t>& cellBounds, SC4Rect<int32_t>& clipped) const
+{
+	clipped.topLeftX = std::max(cellBounds.topLeftX, 0);
+	clipped.topLeftY = std::max(cellBounds.topLeftY, 0);
+	clipped.bottomRightX = std::min(cellBounds.bottomRightX, cellCountX - 1);
+	clipped.bottomRightY = std::min(cellBounds.bottomRightY, cellCountZ - 1);
+
+	return clipped.topLeftX <= clipped.bottomRightX && clipped.topLeftY <= clipped.bottomRightY;
+}
@@ -0,0 +1,85 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "BitsetCellRegion.h"
+#include "cISC4ZoneManager.h"
+#include "OccupantCategory.h"
+#include "SC4Rect.h"
+#include <array>
+#include <cstdint>
+#include <vector>
+
+class cISC4Occupant;
+
+// The city's occupants bucketed by the cells that they cover.
+//
+// Each category also has a city-sized bitset of the cells that contain at least one of
+// its occupants, so the cells of a selection that do not hold any occupants that a
+// bulldoze mode includes can be removed a word at a time.
+class OccupantSpatialIndex
+{
+public:
+	struct Entry
+	{
+		cISC4Occupant* pOccupant;
+		OccupantCategory category;
+		// The network type flags of a network occupant.
+		uint32_t networkFlags;
+		// The zone type of a lot occupant's lot.
+		cISC4ZoneManager::ZoneType zoneType;
+		// Set by Insert when the occupant is in more than one cell's list.
+		bool coversMultipleCells;
+	};
+
+	OccupantSpatialIndex();
+
+	// Resizes the index to the city size and removes all occupants.
+	void Reset(int32_t cellCountX, int32_t cellCountZ);
+
+	void Insert(const SC4Rect<int32_t>& cellBounds, const Entry& entry);
+	void Remove(const SC4Rect<int32_t>& cellBounds, cISC4Occupant* pOccupant);
+
+	// Gets the occupants that cover a cell, the coordinates are in city cells.
+	const std::vector<Entry>& GetCellOccupants(int32_t x, int32_t z) const;
+
+	// Returns true if a cell of the rectangle contains an occupant in one of the categories.
+	bool HasOccupants(const SC4Rect<int32_t>& rect, uint32_t categoryFlags) const;
+
+	// Clears the cells of the region that do not contain an occupant in one of the categories.
+	void RemoveCellsWithoutOccupants(BitsetCellRegion& region, uint32_t categoryFlags);
+
+private:
+	struct Cell
+	{
+		std::vector<Entry> occupants;
+		std::array<uint32_t, kOccupantCategoryCount> categoryCounts;
+	};
+
+	bool ClipToCity(const SC4Rect<int32_t>& cellBounds, SC4Rect<int32_t>& clipped) const;
+
+	int32_t cellCountX;
+	int32_t cellCountZ;
+	std::vector<Cell> cells;
+	std::array<BitsetCellRegion, kOccupantCategoryCount> categoryCells;
+	BitsetCellRegion scratch;
+	const std::vector<Entry> emptyCell;
+};
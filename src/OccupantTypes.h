@@ -0,0 +1,37 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <cstdint>
+
+constexpr uint32_t kBuildingOccupantType = 0x278128A0;
+constexpr uint32_t kFloraOccupantType = 0x74758926;
+constexpr uint32_t kNetworkOccupantType = 0x088E1962;
+constexpr uint32_t kPropOccupantType = 0x2977AA47;
+
+// Returns false for the occupant types that are known to never implement cISC4NetworkOccupant,
+// this allows the filters to skip the QueryInterface call for those occupants.
+inline constexpr bool IsPossibleNetworkOccupantType(uint32_t type)
+{
+	return type != kFloraOccupantType
+		&& type != kBuildingOccupantType
+		&& type != kPropOccupantType;
+}
@@ -0,0 +1,77 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+#include "cISC4Occupant.h"
+#include "cSC4BaseOccupantFilter.h"
+#include "OccupantPredicates.h"
+
+// An occupant filter that evaluates a compile-time predicate chain, see OccupantPredicates.h.
+template<class Predicate>
+class PredicateOccupantFilter : public cSC4BaseOccupantFilter
+{
+public:
+	PredicateOccupantFilter()
+		: PredicateOccupantFilter(nullptr)
+	{
+	}
+
+	// The classification memo is optional, it is used to skip the cISC4NetworkOccupant
+	// and lot manager queries for occupants that were already classified by an earlier preview.
+	PredicateOccupantFilter(OccupantClassificationMemo* pClassificationMemo)
+		: pClassificationMemo(pClassificationMemo),
+		  lotZoneTypes()
+	{
+	}
+
+	bool IsOccupantIncluded(cISC4Occupant* pOccupant) override
+	{
+		if constexpr (Predicate::kTypeOnly)
+		{
+			// The game calls IsOccupantTypeIncluded first, an occupant that reaches
+			// this method has already passed the type check.
+			return true;
+		}
+		else
+		{
+			OccupantPredicateContext context(pOccupant, pClassificationMemo, lotZoneTypes);
+
+			return Predicate::Evaluate(context);
+		}
+	}
+
+	bool IsOccupantTypeIncluded(uint32_t type) override
+	{
+		return Predicate::EvaluateType(type) != PredicateResult::False;
+	}
+
+	// Clears the cached lot zone types, a filter instance that is reused for more than one
+	// demolition must call this before each one.
+	void ClearLotZoneTypes()
+	{
+		lotZoneTypes.Clear();
+	}
+
+private:
+	OccupantClassificationMemo* pClassificationMemo;
+	LotZoneTypeCache lotZoneTypes;
+};
@@ -0,0 +1,120 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PreviewScheduler.h"
+
+PreviewScheduler::PreviewScheduler()
+	: lastKey(),
+	  computingKey(),
+	  lastComputeTimeMs(0),
+	  lastResult(false),
+	  lastTotalCost(0),
+	  hasResult(false),
+	  stale(false),
+	  computing(false),
+	  pendingUpdate(false)
+{
+}
+
+bool PreviewScheduler::TryGetResult(
+	const SC4Rect<int32_t>& bounds,
+	uint64_t selectionKey,
+	uint64_t timeMs,
+	bool& result,
+	int64_t& totalCost)
+{
+	const Key key
+	{
+		bounds.topLeftX,
+		bounds.topLeftY,
+		bounds.bottomRightX,
+		bounds.bottomRightY,
+		selectionKey,
+	};
+
+	const bool unchanged = key == lastKey && !stale;
+
+	if (hasResult && (unchanged || (timeMs - lastComputeTimeMs) < kFrameIntervalMs))
+	{
+		// A changed selection within the frame interval shows the previous result until
+		// the pending update is run.
+		pendingUpdate = !unchanged;
+
+		result = lastResult;
+		totalCost = lastTotalCost;
+		return true;
+	}
+
+	computingKey = key;
+	computing = true;
+	lastComputeTimeMs = timeMs;
+	return false;
+}
+
+void PreviewScheduler::SetResult(bool result, int64_t totalCost)
+{
+	if (computing)
+	{
+		lastKey = computingKey;
+		lastResult = result;
+		lastTotalCost = totalCost;
+		hasResult = true;
+		stale = false;
+		computing = false;
+		pendingUpdate = false;
+	}
+}
+
+bool PreviewScheduler::HasPendingUpdate() const
+{
+	return pendingUpdate;
+}
+
+void PreviewScheduler::Invalidate()
+{
+	hasResult = false;
+	stale = false;
+	computing = false;
+	pendingUpdate = false;
+}
+
+void PreviewScheduler::MarkStale()
+{
+	if (hasResult)
+	{
+		stale = true;
+		pendingUpdate = true;
+	}
+}
+
+uint64_t PreviewScheduler::CombineKey(uint64_t key, uint64_t value)
+{
+	// FNV-1a over the bytes of the value.
+	constexpr uint64_t kFnvPrime = 0x100000001b3;
+
+	for (int i = 0; i < 8; i++)
+	{
+		key ^= (value >> (i * 8)) & 0xff;
+		key *= kFnvPrime;
+	}
+
+	return key;
+}
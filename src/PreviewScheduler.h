@@ -0,0 +1,90 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include "SC4Rect.h"
+#include <cstdint>
+
+// Coalesces the dry run demolitions that the bulldoze tool uses to preview the selection cost.
+//
+// The game updates the preview for every mouse move, and the mouse wheel shortcuts update
+// it for every notch. The dry run is skipped when the selection is unchanged since the
+// last one, and a changed selection is recomputed at most once per frame interval.
+// Updates that arrive within the interval reuse the last result and are marked as pending,
+// the caller is expected to request another update once the selection has been idle.
+// Only the result and the cost are kept, a dry run that must fill the game's demolished
+// occupant set cannot use the last result.
+class PreviewScheduler
+{
+public:
+	static constexpr uint64_t kFrameIntervalMs = 16;
+
+	PreviewScheduler();
+
+	// Gets the result of the last dry run if it can be used for the selection.
+	// The selection key identifies the selected cells within the bounds and the bulldoze mode.
+	// Returns false if the caller should run the dry run and pass its result to SetResult.
+	bool TryGetResult(
+		const SC4Rect<int32_t>& bounds,
+		uint64_t selectionKey,
+		uint64_t timeMs,
+		bool& result,
+		int64_t& totalCost);
+
+	void SetResult(bool result, int64_t totalCost);
+
+	// Returns true if an update was coalesced and the last result is stale.
+	bool HasPendingUpdate() const;
+
+	void Invalidate();
+
+	// Marks the last result as stale after the city's occupants have changed.
+	// The last result is still shown within the frame interval, and an update is pending
+	// so that the caller recomputes it once the selection is idle.
+	void MarkStale();
+
+	// Mixes a value into a selection key.
+	static uint64_t CombineKey(uint64_t key, uint64_t value);
+
+	static constexpr uint64_t kInitialKey = 0xcbf29ce484222325;
+
+private:
+	struct Key
+	{
+		int32_t minX;
+		int32_t minZ;
+		int32_t maxX;
+		int32_t maxZ;
+		uint64_t selectionKey;
+
+		bool operator==(const Key& other) const = default;
+	};
+
+	Key lastKey;
+	Key computingKey;
+	uint64_t lastComputeTimeMs;
+	bool lastResult;
+	int64_t lastTotalCost;
+	bool hasResult;
+	bool stale;
+	bool computing;
+	bool pendingUpdate;
+};
@@ -20,13 +20,6 @@
  */
 
 #pragma once
-#include "NetworkOccupantFilterBase.h"
-
-class RemoveNetworksOccupantFilter : public NetworkOccupantFilterBase
-{
-public:
-	RemoveNetworksOccupantFilter(NetworkTypeFlags networkFlags);
-
-	bool IsOccupantIncluded(cISC4Occupant* pOccupant) override;
-};
+#include "PredicateOccupantFilter.h"
 
+using RemoveNetworksOccupantFilter = PredicateOccupantFilter<HasNetworkFlags<NetworkTypeFlags::AllTransportationNetworks>>;
@@ -0,0 +1,87 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TaskbarProgress.h"
+#include <utility>
+
+TaskbarProgress::TaskbarProgress()
+	: window(nullptr),
+	  taskbarList(),
+	  comInitialized(false)
+{
+}
+
+TaskbarProgress::~TaskbarProgress()
+{
+	Finish();
+}
+
+void TaskbarProgress::Start(HWND window)
+{
+	Finish();
+
+	if (!window)
+	{
+		return;
+	}
+
+	const HRESULT hr = CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+	comInitialized = SUCCEEDED(hr);
+
+	// The game may have initialized COM on its thread with another apartment type.
+	if (comInitialized || hr == RPC_E_CHANGED_MODE)
+	{
+		wil::com_ptr_nothrow<ITaskbarList3> list;
+
+		if (SUCCEEDED(CoCreateInstance(CLSID_TaskbarList, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(list.put())))
+			&& SUCCEEDED(list->HrInit()))
+		{
+			this->window = window;
+			taskbarList = std::move(list);
+			taskbarList->SetProgressState(window, TBPF_NORMAL);
+		}
+	}
+}
+
+void TaskbarProgress::SetProgress(uint64_t completed, uint64_t total)
+{
+	if (taskbarList)
+	{
+		taskbarList->SetProgressValue(window, completed, total);
+	}
+}
+
+void TaskbarProgress::Finish()
+{
+	if (taskbarList)
+	{
+		taskbarList->SetProgressState(window, TBPF_NOPROGRESS);
+		taskbarList.reset();
+	}
+
+	window = nullptr;
+
+	if (comInitialized)
+	{
+		CoUninitialize();
+		comInitialized = false;
+	}
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is part of sc4-bulldoze-extensions, a DLL Plugin for
+ * SimCity 4 extends the bulldoze tool.
+ *
+ * Copyright (C) 2024, 2025 Nicholas Hayes
+ *
+ * sc4-bulldoze-extensions is free software: you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation, either version 3 of
+ * the License, or (at your option) any later version.
+ *
+ * sc4-bulldoze-extensions is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with sc4-bulldoze-extensions.
+ * If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+#include <Windows.h>
+#include <ShObjIdl.h>
+#include "wil/com.h"
+#include <cstdint>
+
+// Shows the progress of a long operation on the game's taskbar button.
+//
+// The progress is only shown when the taskbar is available, the operation runs the same
+// way without it.
+class TaskbarProgress
+{
+public:
+	TaskbarProgress();
+	~TaskbarProgress();
+
+	// Starts showing the progress on the taskbar button of the window.
+	void Start(HWND window);
+
+	void SetProgress(uint64_t completed, uint64_t total);
+
+	// Removes the progress from the taskbar button.
+	void Finish();
+
+private:
+	HWND window;
+	wil::com_ptr_nothrow<ITaskbarList3> taskbarList;
+	bool comInitialized;
+};
@@ -20,26 +20,41 @@
  */
 
 #include "cSC4ViewInputControlDemolishHooks.h"
+#include "CellRegionRasterizer.h"
 #include "cIGZAllocatorService.h"
 #include "cISC4Demolition.h"
 #include "cISC4OccupantFilter.h"
+#include "ChunkedDemolition.h"
 #include "cRZAutoRefCount.h"
+#include "DemolitionEffectAggregator.h"
 #include "DezoneKeepNetworksOccupantFilter.h"
+#include "DiagonalRegionCache.h"
 #include "FloraOccupantFilter.h"
 #include "GZServPtrs.h"
 #include "IBulldozeHighlightColors.h"
+#include "ICityOccupantIndex.h"
+#include "IOccupantFilterExpressions.h"
 #include "Logger.h"
 #include "KeepNetworksOccupantFilter.h"
+#include "MultiSelectionRegion.h"
+#include "OccupantClassificationMemo.h"
+#include "OccupantDemolitionDriver.h"
+#include "OccupantSpatialIndex.h"
 #include "Patcher.h"
+#include "PreviewScheduler.h"
 #include "RemoveNetworksOccupantFilter.h"
 #include "SC4CellRegion.h"
 #include "SC4List.h"
 #include "SC4VersionDetection.h"
+#include "TaskbarProgress.h"
 #include <Windows.h>
 #include "wil/result.h"
 #include <cstdint>
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <optional>
+#include <vector>
 
 namespace
 {
@@ -102,6 +117,21 @@ namespace
 		uint32_t modifiers);
 	static const auto RealOnMouseUpL = reinterpret_cast<PFN_cSC4ViewInputControlDemolish_OnMouseUpL>(0x4b9c50);
 
+	typedef bool(__thiscall* PFN_cSC4ViewInputControlDemolish_OnMouseDownL)(
+		cSC4ViewInputControlDemolish* pThis,
+		int32_t x,
+		int32_t z,
+		uint32_t modifiers);
+	// Read from the jump table before our hook replaces it.
+	static PFN_cSC4ViewInputControlDemolish_OnMouseDownL RealOnMouseDownL = nullptr;
+
+	typedef bool(__thiscall* PFN_cSC4ViewInputControlDemolish_OnKeyUp)(
+		cSC4ViewInputControlDemolish* pThis,
+		int32_t vkCode,
+		int32_t modifiers);
+	// Read from the jump table before our hook replaces it.
+	static PFN_cSC4ViewInputControlDemolish_OnKeyUp RealOnKeyUp = nullptr;
+
 	enum class OccupantFilterType
 	{
 		None = 0,
@@ -110,6 +140,17 @@ namespace
 		DezoneKeepNetworks = 3,
 	};
 
+	enum class SelectionShape
+	{
+		Rectangle = 0,
+		Diagonal = 1,
+		Lasso = 2,
+		Ellipse = 3,
+		CircleBrush = 4,
+		Line = 5,
+		Polyline = 6,
+	};
+
 	enum ModifierKeyFlags : int32_t
 	{
 		ModifierKeyFlagNone = 0,
@@ -119,166 +160,304 @@ namespace
 		ModifierKeyFlagAll = ModifierKeyFlagShift | ModifierKeyFlagControl | ModifierKeyFlagAlt,
 	};
 
+	// The game's dry run results and costs of the network mode's partitions for the last selection,
+	// the demolished occupant sets are not cached.
+	// Index 0 is the partition that the mode removes, index 1 is the partition that it removes
+	// when Shift is held.
+	struct NetworkPartitionPreview
+	{
+		uint64_t selectionKey;
+		bool valid;
+		bool partitionKnown[2];
+		bool partitionResult[2];
+		int64_t partitionCost[2];
+	};
+
+	// The arguments that each chunk of a chunked demolition is demolished with, the occupant filter
+	// is resolved when the demolition starts so that mode changes do not affect the later chunks.
+	struct ChunkedDemolitionState
+	{
+		cRZAutoRefCount<cISC4Demolition> demolition;
+		uint32_t privilegeType;
+		uint32_t flags;
+		bool clearZonedArea;
+		cRZAutoRefCount<cISC4OccupantFilter> occupantFilter;
+		cRZAutoRefCount<cISC4Occupant> demolishEffectOccupant;
+		long demolishEffectX;
+		long demolishEffectZ;
+		uint32_t includedCategories;
+		// The demolition effects that the remaining chunks may spawn.
+		uint32_t remainingEffects;
+		size_t removedOccupantCount;
+	};
+
 	static constexpr int32_t kDefaultDiagonalThickness = 1; // Single line
-	static constexpr int32_t kMaxDiagonalThickness = 9;
+	static constexpr int32_t kMaxDiagonalThickness = 64;
+	static constexpr int32_t kDefaultBrushRadius = 4;
+	static constexpr int32_t kMaxBrushRadius = 128;
+	static constexpr int32_t kDefaultLineWidth = 1;
+	static constexpr int32_t kMaxLineWidth = 64;
+	static constexpr int32_t kLineSnapAngle = 15;
 
 	static OccupantFilterType occupantFilterType = OccupantFilterType::None;
-	static bool diagonalMode = false;
+	static SelectionShape selectionShape = SelectionShape::Rectangle;
 	static int32_t diagonalThickness = kDefaultDiagonalThickness;
+	static int32_t brushRadius = kDefaultBrushRadius;
+	static int32_t lineWidth = kDefaultLineWidth;
 	static cSC4ViewInputControlDemolish* currentViewControl = nullptr;
 	static ModifierKeyFlags keyUpModifiers = ModifierKeyFlagNone;
+	// The Control and Alt state when the current selection was started, these select the
+	// multi-selection operation.
+	static ModifierKeyFlags selectionStartModifiers = ModifierKeyFlagNone;
+	static DiagonalRegionCache diagonalRegionCache;
+	static MultiSelectionRegion multiSelection;
+	static std::vector<CellRegionRasterizer::CellPoint> pathVertices;
+	static std::vector<CellRegionRasterizer::CellPoint> pathPreviewVertices;
+	static bool pathCompleted = false;
+	static int32_t pathMouseX = 0;
+	static int32_t pathMouseZ = 0;
+	static BitsetCellRegion shapeRegion;
+	static PreviewScheduler previewScheduler;
+	static BitsetCellRegion occupantCells;
+	static BitsetCellRegion occupantCellsBounds;
+	// The regions that are passed to the game on the mouse move path are kept between the
+	// preview updates, so that they are only reallocated when their bounds grow.
+	static ReusableCellRegion shapeCellRegion;
+	static ReusableCellRegion occupantCellRegion;
+	static std::optional<SC4CellRegion<int32_t>> emptySelectionCellRegion;
+	// The regions of the driver's selection and its effect and quiet cells.
+	static ReusableCellRegion selectedCellRegion;
+	static ReusableCellRegion effectCellRegion;
+	static ReusableCellRegion quietCellRegion;
+	static OccupantClassificationMemo occupantClassificationMemo;
+	// The occupant filters are created once when the hooks are installed, this keeps
+	// the preview updates during a drag free of heap allocations.
+	static cRZAutoRefCount<FloraOccupantFilter> floraOccupantFilter;
+	static cRZAutoRefCount<KeepNetworksOccupantFilter> keepNetworksOccupantFilter;
+	static cRZAutoRefCount<RemoveNetworksOccupantFilter> removeNetworksOccupantFilter;
+	static cRZAutoRefCount<DezoneKeepNetworksOccupantFilter> dezoneKeepNetworksOccupantFilter;
+	static NetworkPartitionPreview networkPartitionPreview{};
+	static OccupantDemolitionDriver demolitionDriver;
+	static DemolitionEffectAggregator demolitionEffectAggregator;
+	static UINT_PTR previewTimerID = 0;
+	static ChunkedDemolition chunkedDemolition;
+	static ChunkedDemolitionState chunkedDemolitionState{};
+	static UINT_PTR chunkedDemolitionTimerID = 0;
+	static TaskbarProgress chunkedDemolitionProgress;
+
+	// The time that the selection must be unchanged before a coalesced preview update is run.
+	static constexpr UINT kPreviewIdleMs = 50;
+	// Selections with more cells than this are demolished over several frames.
+	static constexpr uint64_t kChunkedDemolitionMinCells = 16384;
+	// The maximum number of selected cells that are demolished in one frame.
+	static constexpr uint64_t kChunkedDemolitionCellsPerChunk = 4096;
+	static constexpr UINT kChunkedDemolitionIntervalMs = USER_TIMER_MINIMUM;
+	// The maximum number of demolition effects that one bulldoze operation spawns.
+	static constexpr uint32_t kMaxDemolitionEffects = 32;
+
+	typedef bool(__thiscall* cSC4ViewInputControl_IsOnTop)(cISC4ViewInputControl* pThis);
+
+	static const cSC4ViewInputControl_IsOnTop IsOnTop = reinterpret_cast<cSC4ViewInputControl_IsOnTop>(0x5fb190);
+
+	typedef void(__thiscall* cSC4ViewInputControlDemolish_ThiscallFn)(cSC4ViewInputControlDemolish* pThis);
 
-	// Helper function to create a diagonal region from two points with drag direction detection and thickness
-	SC4CellRegion<int32_t> CreateDiagonalRegion(int32_t x1, int32_t z1, int32_t x2, int32_t z2, int32_t startX = -1, int32_t startZ = -1)
+	static const cSC4ViewInputControlDemolish_ThiscallFn EndInput = reinterpret_cast<cSC4ViewInputControlDemolish_ThiscallFn>(0x4b9040);
+	static const cSC4ViewInputControlDemolish_ThiscallFn UpdateSelectedRegion = reinterpret_cast<cSC4ViewInputControlDemolish_ThiscallFn>(0x4b93b0);
+
+	void CreateOccupantFilters()
 	{
-		// Calculate bounding box for the region
-		int32_t minX = (std::min)(x1, x2);
-		int32_t maxX = (std::max)(x1, x2);
-		int32_t minZ = (std::min)(z1, z2);
-		int32_t maxZ = (std::max)(z1, z2);
+		floraOccupantFilter = new FloraOccupantFilter();
+		keepNetworksOccupantFilter = new KeepNetworksOccupantFilter(&occupantClassificationMemo);
+		removeNetworksOccupantFilter = new RemoveNetworksOccupantFilter(&occupantClassificationMemo);
+		dezoneKeepNetworksOccupantFilter = new DezoneKeepNetworksOccupantFilter(&occupantClassificationMemo);
+	}
 
-		// Create region with all cells initially false
-		SC4CellRegion<int32_t> region(minX, minZ, maxX, maxZ, false);
+	void ClearPathVertices()
+	{
+		pathVertices.clear();
+		pathCompleted = false;
+	}
 
-		// Determine diagonal direction based on click position relative to bounding box
-		int32_t diagStartX, diagStartZ, diagEndX, diagEndZ;
+	void CALLBACK PreviewTimerProc(HWND hwnd, UINT message, UINT_PTR timerID, DWORD time)
+	{
+		KillTimer(nullptr, timerID);
+		previewTimerID = 0;
 
-		if (startX != -1 && startZ != -1)
+		if (currentViewControl
+			&& currentViewControl->bCellPicked
+			&& currentViewControl->pCellRegion
+			&& previewScheduler.HasPendingUpdate())
 		{
-			// Use the reliable click coordinates to determine diagonal direction
-			// Simply draw from the click point to the opposite corner
-			int32_t centerX = (minX + maxX) / 2;
-			int32_t centerZ = (minZ + maxZ) / 2;
-
-			if (startX <= centerX && startZ <= centerZ)
-			{
-				// Click in northwest area -> draw NW to SE
-				diagStartX = minX; diagStartZ = minZ;
-				diagEndX = maxX; diagEndZ = maxZ;
-			}
-			else if (startX > centerX && startZ <= centerZ)
-			{
-				// Click in northeast area -> draw NE to SW
-				diagStartX = maxX; diagStartZ = minZ;
-				diagEndX = minX; diagEndZ = maxZ;
-			}
-			else if (startX <= centerX && startZ > centerZ)
-			{
-				// Click in southwest area -> draw SW to NE
-				diagStartX = minX; diagStartZ = maxZ;
-				diagEndX = maxX; diagEndZ = minZ;
-			}
-			else
-			{
-				// Click in southeast area -> draw SE to NW
-				diagStartX = maxX; diagStartZ = maxZ;
-				diagEndX = minX; diagEndZ = minZ;
-			}
+			UpdateSelectedRegion(currentViewControl);
 		}
-		else
+	}
+
+	void SchedulePreviewUpdate()
+	{
+		// Setting the timer again restarts it, so the update runs once the selection is idle.
+		previewTimerID = SetTimer(nullptr, previewTimerID, kPreviewIdleMs, &PreviewTimerProc);
+	}
+
+	void CancelPreviewUpdate()
+	{
+		if (previewTimerID != 0)
 		{
-			// No start point provided - use default NW-to-SE diagonal
-			diagStartX = minX; diagStartZ = minZ;
-			diagEndX = maxX; diagEndZ = maxZ;
+			KillTimer(nullptr, previewTimerID);
+			previewTimerID = 0;
 		}
 
-		// Use Bresenham's line algorithm to mark diagonal cells
-		int32_t dx = abs(diagEndX - diagStartX);
-		int32_t dz = abs(diagEndZ - diagStartZ);
-		int32_t sx = diagStartX < diagEndX ? 1 : -1;
-		int32_t sz = diagStartZ < diagEndZ ? 1 : -1;
-		int32_t err = dx - dz;
+		previewScheduler.Invalidate();
+	}
+
+	// The cached preview results were computed from the previous city state.
+	void CityOccupantsChanged()
+	{
+		networkPartitionPreview.valid = false;
+		previewScheduler.MarkStale();
 
+		if (currentViewControl && currentViewControl->bCellPicked && previewScheduler.HasPendingUpdate())
+		{
+			SchedulePreviewUpdate();
+		}
+	}
 
-		int32_t currentX = diagStartX;
-		int32_t currentZ = diagStartZ;
-		int32_t tileCount = 0;
+	// Gets the cell under the cursor, the selected region spans from the click cell to this cell.
+	CellRegionRasterizer::CellPoint GetDragEndCell(const cSC4ViewInputControlDemolish* pThis)
+	{
+		const auto& bounds = pThis->pCellRegion->bounds;
 
-		while (true)
+		return CellRegionRasterizer::CellPoint
 		{
-			// Set the current cell and perpendicular cells for thickness
-			// Handle positive/negative thickness values (skip 0)
-			int32_t startOffset, endOffset;
+			bounds.topLeftX == pThis->clickX ? bounds.bottomRightX : bounds.topLeftX,
+			bounds.topLeftY == pThis->clickZ ? bounds.bottomRightY : bounds.topLeftY,
+		};
+	}
 
-			if (diagonalThickness > 0)
-			{
-				startOffset = 0;
-				endOffset = diagonalThickness - 1;
-			}
-			else
-			{
-				startOffset = diagonalThickness + 1;
-				endOffset = 0;
-			}
+	bool IsLassoClosingCell(const CellRegionRasterizer::CellPoint& cell)
+	{
+		// The polygon is closed by clicking on or next to its first vertex.
+		if (pathVertices.size() < 3)
+		{
+			return false;
+		}
 
-			for (int32_t thickOffset = startOffset; thickOffset <= endOffset; thickOffset++)
-			{
-				// Calculate perpendicular offset based on line direction
-				int32_t perpX, perpZ;
+		const CellRegionRasterizer::CellPoint& first = pathVertices.front();
 
-				if (abs(dx) > abs(dz))
-				{
-					// More horizontal line - add thickness vertically
-					perpX = currentX;
-					perpZ = currentZ + thickOffset;
-				}
-				else
-				{
-					// More vertical line - add thickness horizontally
-					perpX = currentX + thickOffset;
-					perpZ = currentZ;
-				}
+		return abs(cell.x - first.x) <= 1 && abs(cell.z - first.z) <= 1;
+	}
 
-				int32_t cellX = perpX - minX;
-				int32_t cellZ = perpZ - minZ;
+	// The shapes that are drawn into shapeRegion instead of the view control's region.
+	bool IsRasterizedShape(SelectionShape shape)
+	{
+		return shape == SelectionShape::Lasso
+			|| shape == SelectionShape::Ellipse
+			|| shape == SelectionShape::CircleBrush
+			|| shape == SelectionShape::Line
+			|| shape == SelectionShape::Polyline;
+	}
 
-				if (cellX >= 0 && cellX < (maxX - minX + 1) && cellZ >= 0 && cellZ < (maxZ - minZ + 1))
-				{
-					region.cellMap.SetValue(cellX, cellZ, true);
-					tileCount++;
-				}
-			}
+	// Gets the vertices of the lasso or polyline path.
+	// While the path is being drawn the cell under the cursor is included as its next vertex.
+	const std::vector<CellRegionRasterizer::CellPoint>& GetPathVertices(const cSC4ViewInputControlDemolish* pThis)
+	{
+		if (pathCompleted)
+		{
+			return pathVertices;
+		}
 
-			if (currentX == diagEndX && currentZ == diagEndZ)
-			{
-				break;
-			}
+		pathPreviewVertices = pathVertices;
 
-			int32_t e2 = 2 * err;
+		if (pathPreviewVertices.empty())
+		{
+			pathPreviewVertices.push_back(CellRegionRasterizer::CellPoint{ pThis->clickX, pThis->clickZ });
+		}
 
-			if (e2 > -dz)
-			{
-				err -= dz;
-				currentX += sx;
-			}
-			if (e2 < dx)
-			{
-				err += dx;
-				currentZ += sz;
-			}
+		pathPreviewVertices.push_back(GetDragEndCell(pThis));
+
+		return pathPreviewVertices;
+	}
+
+	void AddPathVertex(const cSC4ViewInputControlDemolish* pThis)
+	{
+		if (pathVertices.empty())
+		{
+			pathVertices.push_back(CellRegionRasterizer::CellPoint{ pThis->clickX, pThis->clickZ });
 		}
 
-		return region;
+		const CellRegionRasterizer::CellPoint cell = GetDragEndCell(pThis);
+
+		if (pathVertices.back() != cell)
+		{
+			pathVertices.push_back(cell);
+		}
 	}
 
-	typedef bool(__thiscall* cSC4ViewInputControl_IsOnTop)(cISC4ViewInputControl* pThis);
+	void RasterizeShape(const cSC4ViewInputControlDemolish* pThis)
+	{
+		const auto& bounds = pThis->pCellRegion->bounds;
 
-	static const cSC4ViewInputControl_IsOnTop IsOnTop = reinterpret_cast<cSC4ViewInputControl_IsOnTop>(0x5fb190);
+		switch (selectionShape)
+		{
+		case SelectionShape::Lasso:
+			CellRegionRasterizer::RasterizePolygon(GetPathVertices(pThis), shapeRegion);
+			break;
+		case SelectionShape::Polyline:
+			CellRegionRasterizer::RasterizePolyline(GetPathVertices(pThis), lineWidth, shapeRegion);
+			break;
+		case SelectionShape::Ellipse:
+			CellRegionRasterizer::RasterizeEllipse(
+				bounds.topLeftX,
+				bounds.topLeftY,
+				bounds.bottomRightX,
+				bounds.bottomRightY,
+				shapeRegion);
+			break;
+		case SelectionShape::CircleBrush:
+		{
+			// The brush is centered on the cell under the cursor.
+			const CellRegionRasterizer::CellPoint center = GetDragEndCell(pThis);
+
+			CellRegionRasterizer::RasterizeEllipse(
+				center.x - brushRadius,
+				center.z - brushRadius,
+				center.x + brushRadius,
+				center.z + brushRadius,
+				shapeRegion);
+		}
+		break;
+		case SelectionShape::Line:
+		{
+			const CellRegionRasterizer::CellPoint start{ pThis->clickX, pThis->clickZ };
+			CellRegionRasterizer::CellPoint end = GetDragEndCell(pThis);
 
-	typedef void(__thiscall* cSC4ViewInputControlDemolish_ThiscallFn)(cSC4ViewInputControlDemolish* pThis);
+			// Holding Shift snaps the line to the nearest multiple of 15 degrees.
+			if ((GetKeyState(VK_SHIFT) & 0x8000) != 0)
+			{
+				end = CellRegionRasterizer::SnapLineEnd(start, end, kLineSnapAngle);
+			}
 
-	static const cSC4ViewInputControlDemolish_ThiscallFn EndInput = reinterpret_cast<cSC4ViewInputControlDemolish_ThiscallFn>(0x4b9040);
-	static const cSC4ViewInputControlDemolish_ThiscallFn UpdateSelectedRegion = reinterpret_cast<cSC4ViewInputControlDemolish_ThiscallFn>(0x4b93b0);
+			CellRegionRasterizer::RasterizeLine(start, end, lineWidth, shapeRegion);
+		}
+		break;
+		}
+	}
 
-	void SetOccupantFilterOption(cSC4ViewInputControlDemolish* pThis, OccupantFilterType type, bool diagonal)
+	void SetOccupantFilterOption(cSC4ViewInputControlDemolish* pThis, OccupantFilterType type, SelectionShape shape)
 	{
 		// Always store the current view control for use in other hooks
 		currentViewControl = pThis;
 
-		if (occupantFilterType != type || diagonalMode != diagonal)
+		if (occupantFilterType != type || selectionShape != shape)
 		{
+			if (selectionShape != shape)
+			{
+				ClearPathVertices();
+			}
+
 			occupantFilterType = type;
-			diagonalMode = diagonal;
+			selectionShape = shape;
+
+			const bool diagonalMode = selectionShape == SelectionShape::Diagonal;
 
 			// Set cursor based on occupant filter type and diagonal mode
 			switch (occupantFilterType)
@@ -307,49 +486,14 @@ namespace
 			if (pThis->bCellPicked)
 			{
 				// Safely modify existing pCellRegion contents
-				if (diagonal && pThis->pCellRegion)
+				if (diagonalMode && pThis->pCellRegion)
 				{
-					// Get current rectangular bounds
-					const auto& bounds = pThis->pCellRegion->bounds;
-
-					// Create diagonal region using reliable click coordinates
-					SC4CellRegion<int32_t> diagonalRegion = CreateDiagonalRegion(
-						bounds.topLeftX,
-						bounds.topLeftY,
-						bounds.bottomRightX,
-						bounds.bottomRightY,
+					// Draw the diagonal directly into the existing cellMap using reliable click coordinates
+					diagonalRegionCache.Apply(
+						*pThis->pCellRegion,
+						diagonalThickness,
 						pThis->clickX,
-						pThis->clickZ
-					);
-
-					// Only modify the cellMap contents, not the structure
-					// Copy diagonal pattern into existing cellMap without changing pointers
-					auto& existingCellMap = pThis->pCellRegion->cellMap;
-					const auto& diagonalCellMap = diagonalRegion.cellMap;
-
-					// Calculate dimensions from bounds (both regions should have same bounds)
-					const auto& existingBounds = pThis->pCellRegion->bounds;
-					const auto& diagonalBounds = diagonalRegion.bounds;
-
-					uint32_t width = static_cast<uint32_t>(bounds.bottomRightX - bounds.topLeftX + 1);
-					uint32_t height = static_cast<uint32_t>(bounds.bottomRightY - bounds.topLeftY + 1);
-
-					// Verify bounds match before copying
-					if (existingBounds.topLeftX == diagonalBounds.topLeftX &&
-						existingBounds.topLeftY == diagonalBounds.topLeftY &&
-						existingBounds.bottomRightX == diagonalBounds.bottomRightX &&
-						existingBounds.bottomRightY == diagonalBounds.bottomRightY)
-					{
-						// Copy cell values from diagonal pattern to existing map
-						for (uint32_t x = 0; x < width; x++)
-						{
-							for (uint32_t z = 0; z < height; z++)
-							{
-								bool diagonalValue = diagonalCellMap.GetValue(x, z);
-								existingCellMap.SetValue(x, z, diagonalValue);
-							}
-						}
-					}
+						pThis->clickZ);
 				}
 
 				UpdateSelectedRegion(pThis);
@@ -357,6 +501,65 @@ namespace
 		}
 	}
 
+	void AddToMultiSelection(cSC4ViewInputControlDemolish* pThis, bool subtract)
+	{
+		if (IsRasterizedShape(selectionShape))
+		{
+			RasterizeShape(pThis);
+
+			if (subtract)
+			{
+				multiSelection.Subtract(shapeRegion);
+			}
+			else
+			{
+				multiSelection.Add(shapeRegion);
+			}
+
+			ClearPathVertices();
+		}
+		else
+		{
+			if (selectionShape == SelectionShape::Diagonal)
+			{
+				diagonalRegionCache.Apply(
+					*pThis->pCellRegion,
+					diagonalThickness,
+					pThis->clickX,
+					pThis->clickZ);
+			}
+
+			if (subtract)
+			{
+				multiSelection.Subtract(*pThis->pCellRegion);
+			}
+			else
+			{
+				multiSelection.Add(*pThis->pCellRegion);
+			}
+		}
+
+		EndInput(pThis);
+		diagonalRegionCache.Invalidate();
+	}
+
+	bool __fastcall OnMouseDownHook(
+		cSC4ViewInputControlDemolish* pThis,
+		void* edxUnused,
+		int32_t x,
+		int32_t z,
+		uint32_t modifiers)
+	{
+		// The multi-selection modifiers are read when a selection is started, Alt is also
+		// held while resizing the brush or line with the mouse wheel during the drag.
+		if (!pThis->bCellPicked && pathVertices.empty())
+		{
+			selectionStartModifiers = static_cast<ModifierKeyFlags>(modifiers & (ModifierKeyFlagControl | ModifierKeyFlagAlt));
+		}
+
+		return RealOnMouseDownL(pThis, x, z, modifiers);
+	}
+
 	bool __fastcall OnMouseUpHook(
 		cSC4ViewInputControlDemolish* pThis,
 		void* edxUnused,
@@ -366,7 +569,53 @@ namespace
 	{
 		keyUpModifiers = static_cast<ModifierKeyFlags>(modifiers & ModifierKeyFlagAll);
 
-		return RealOnMouseUpL(pThis, x, z, modifiers);
+		if (selectionShape == SelectionShape::Lasso && pThis->bCellPicked && pThis->pCellRegion)
+		{
+			if (!IsLassoClosingCell(GetDragEndCell(pThis)))
+			{
+				// Each click adds a vertex to the polygon, the demolition is started when the
+				// polygon is closed.
+				AddPathVertex(pThis);
+				EndInput(pThis);
+				return true;
+			}
+
+			pathCompleted = true;
+		}
+		else if (selectionShape == SelectionShape::Polyline && pThis->bCellPicked && pThis->pCellRegion)
+		{
+			// Each click adds a vertex to the path, the selection is kept active so that the
+			// preview follows the cursor. The path is demolished when Enter is pressed.
+			AddPathVertex(pThis);
+			pathMouseX = x;
+			pathMouseZ = z;
+			return true;
+		}
+
+		// A selection that was started with Control or Alt held is added to or removed from the
+		// multi-selection, the selection is demolished with the next drag that does not use
+		// either modifier.
+		if (pThis->bCellPicked
+			&& pThis->pCellRegion
+			&& selectionStartModifiers != ModifierKeyFlagNone)
+		{
+			AddToMultiSelection(pThis, (selectionStartModifiers & ModifierKeyFlagAlt) == ModifierKeyFlagAlt);
+			selectionStartModifiers = ModifierKeyFlagNone;
+			return true;
+		}
+
+		const bool result = RealOnMouseUpL(pThis, x, z, modifiers);
+
+		// The drag has ended, the next one will start with a new selection.
+		diagonalRegionCache.Invalidate();
+		occupantClassificationMemo.Clear();
+
+		if (pathCompleted)
+		{
+			ClearPathVertices();
+		}
+
+		return result;
 	}
 
 	bool __fastcall OnMouseWheelHook(
@@ -377,8 +626,53 @@ namespace
 		int32_t modifiers,
 		int32_t wheelDelta)
 	{
+		if (selectionShape == SelectionShape::CircleBrush && (modifiers & ModifierKeyFlagAlt))
+		{
+			// Adjust the brush radius based on wheel direction
+			const int32_t oldRadius = brushRadius;
+
+			if (wheelDelta > 0)
+			{
+				brushRadius = (std::min)(brushRadius + 1, kMaxBrushRadius);
+			}
+			else if (wheelDelta < 0)
+			{
+				brushRadius = (std::max)(brushRadius - 1, 0);
+			}
+
+			if (brushRadius != oldRadius && pThis->bCellPicked && pThis->pCellRegion)
+			{
+				UpdateSelectedRegion(pThis);
+			}
+
+			return true;
+		}
+
+		if ((selectionShape == SelectionShape::Line || selectionShape == SelectionShape::Polyline)
+			&& (modifiers & ModifierKeyFlagAlt))
+		{
+			// Adjust the line width based on wheel direction
+			const int32_t oldWidth = lineWidth;
+
+			if (wheelDelta > 0)
+			{
+				lineWidth = (std::min)(lineWidth + 1, kMaxLineWidth);
+			}
+			else if (wheelDelta < 0)
+			{
+				lineWidth = (std::max)(lineWidth - 1, 1);
+			}
+
+			if (lineWidth != oldWidth && pThis->bCellPicked && pThis->pCellRegion)
+			{
+				UpdateSelectedRegion(pThis);
+			}
+
+			return true;
+		}
+
 		// Check if we're in diagonal mode and Alt is held
-		if (diagonalMode && (modifiers & ModifierKeyFlagAlt))
+		if (selectionShape == SelectionShape::Diagonal && (modifiers & ModifierKeyFlagAlt))
 		{
 			// Adjust diagonal thickness based on wheel direction
 			int32_t oldThickness = diagonalThickness;
@@ -414,7 +708,7 @@ namespace
 				if (pThis->bCellPicked && pThis->pCellRegion)
 				{
 					// Trigger preview update by calling SetOccupantFilterOption
-					SetOccupantFilterOption(pThis, occupantFilterType, diagonalMode);
+					SetOccupantFilterOption(pThis, occupantFilterType, selectionShape);
 
 					// Force immediate visual update of the preview
 					UpdateSelectedRegion(pThis);
@@ -429,6 +723,21 @@ namespace
 		return false;
 	}
 
+	// Updates the network mode's preview when the Shift key is pressed or released, a partition
+	// that was already dry run for the selection reuses its result.
+	void UpdateNetworkPreviewShiftState(cSC4ViewInputControlDemolish* pThis, bool shiftHeld)
+	{
+		const bool previewShiftHeld = (keyUpModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift;
+
+		if (occupantFilterType == OccupantFilterType::Network
+			&& pThis->bCellPicked
+			&& pThis->pCellRegion
+			&& shiftHeld != previewShiftHeld)
+		{
+			UpdateSelectedRegion(pThis);
+		}
+	}
+
 	bool __fastcall OnKeyDownHook(
 		cSC4ViewInputControlDemolish* pThis,
 		void* edxUnused,
@@ -441,11 +750,65 @@ namespace
 		{
 			if (vkCode == VK_ESCAPE)
 			{
-				if (pThis->bCellPicked)
+				if (chunkedDemolition.IsActive())
+				{
+					// The timer finishes the canceled demolition on its next tick.
+					chunkedDemolition.Cancel();
+					handled = true;
+				}
+				else if (pThis->bCellPicked)
 				{
 					EndInput(pThis);
+					diagonalRegionCache.Invalidate();
+
+					if (selectionShape == SelectionShape::Polyline)
+					{
+						ClearPathVertices();
+					}
+
+					handled = true;
+				}
+				else if (!pathVertices.empty())
+				{
+					ClearPathVertices();
 					handled = true;
 				}
+				else if (!multiSelection.IsEmpty())
+				{
+					multiSelection.Clear();
+					handled = true;
+				}
+			}
+			else if (vkCode == VK_RETURN)
+			{
+				if (selectionShape == SelectionShape::Polyline
+					&& pathVertices.size() >= 2
+					&& pThis->bCellPicked
+					&& pThis->pCellRegion)
+				{
+					keyUpModifiers = static_cast<ModifierKeyFlags>(modifiers & ModifierKeyFlagAll);
+					pathCompleted = true;
+
+					if (selectionStartModifiers != ModifierKeyFlagNone)
+					{
+						AddToMultiSelection(pThis, (selectionStartModifiers & ModifierKeyFlagAlt) == ModifierKeyFlagAlt);
+						selectionStartModifiers = ModifierKeyFlagNone;
+					}
+					else
+					{
+						// Finish the selection through the game's mouse up handler, the path is
+						// demolished by the OnMouseUpLDemolishRegion hook.
+						RealOnMouseUpL(pThis, pathMouseX, pathMouseZ, modifiers);
+						diagonalRegionCache.Invalidate();
+					}
+
+					ClearPathVertices();
+					handled = true;
+				}
+			}
+			else if (vkCode == VK_SHIFT)
+			{
+				UpdateNetworkPreviewShiftState(pThis, true);
 			}
 			else
 			{
@@ -455,19 +818,21 @@ namespace
 				{
 					handled = true;
 					const uint32_t activeModifiers = modifiers & ModifierKeyFlagAll;
-					const bool isDiagonal = (activeModifiers & ModifierKeyFlagAlt) == ModifierKeyFlagAlt;
+					const SelectionShape shape = (activeModifiers & ModifierKeyFlagAlt) == ModifierKeyFlagAlt ?
+						SelectionShape::Diagonal :
+						SelectionShape::Rectangle;
 
 					if ((activeModifiers & ModifierKeyFlagControl) == ModifierKeyFlagControl)
 					{
-						SetOccupantFilterOption(pThis, OccupantFilterType::Flora, isDiagonal);
+						SetOccupantFilterOption(pThis, OccupantFilterType::Flora, shape);
 					}
 					else if ((activeModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift)
 					{
-						SetOccupantFilterOption(pThis, OccupantFilterType::Network, isDiagonal);
+						SetOccupantFilterOption(pThis, OccupantFilterType::Network, shape);
 					}
 					else
 					{
-						SetOccupantFilterOption(pThis, OccupantFilterType::None, isDiagonal);
+						SetOccupantFilterOption(pThis, OccupantFilterType::None, shape);
 					}
 				}
 				else if (vkCode == 'V')
@@ -479,40 +844,107 @@ namespace
 					if ((activeModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift)
 					{
 						handled = true;
-						SetOccupantFilterOption(pThis, OccupantFilterType::DezoneKeepNetworks, false);
+						SetOccupantFilterOption(pThis, OccupantFilterType::DezoneKeepNetworks, SelectionShape::Rectangle);
 					}
 				}
-			}
-		}
-
-		return handled;
-	}
+				else if (vkCode == 'O')
+				{
+					// Shift + O switches the current bulldoze mode to the circle brush,
+					// and Control + O switches it to the ellipse.
 
-	void __fastcall Activate(cSC4ViewInputControlDemolish* pThis, void* edxUnused)
-	{
-		occupantFilterType = OccupantFilterType::None;
-		diagonalMode = false;
-		diagonalThickness = kDefaultDiagonalThickness; // Reset thickness to default
-		currentViewControl = pThis;
+					const uint32_t activeModifiers = modifiers & ModifierKeyFlagAll;
 
-		switch (pThis->cursorIID)
-		{
-		case cSC4ViewInputControlDemolishHooks::BulldozeCursorFlora:
+					if (activeModifiers == ModifierKeyFlagShift)
+					{
+						handled = true;
+						SetOccupantFilterOption(pThis, occupantFilterType, SelectionShape::CircleBrush);
+					}
+					else if (activeModifiers == ModifierKeyFlagControl)
+					{
+						handled = true;
+						SetOccupantFilterOption(pThis, occupantFilterType, SelectionShape::Ellipse);
+					}
+				}
+				else if (vkCode == 'L')
+				{
+					// Shift + L switches the current bulldoze mode to the lasso selection,
+					// Control + L switches it to the point to point line and Control + Shift + L
+					// switches it to the polyline path.
+
+					const uint32_t activeModifiers = modifiers & ModifierKeyFlagAll;
+
+					if (activeModifiers == ModifierKeyFlagShift)
+					{
+						handled = true;
+						SetOccupantFilterOption(pThis, occupantFilterType, SelectionShape::Lasso);
+					}
+					else if (activeModifiers == ModifierKeyFlagControl)
+					{
+						handled = true;
+						SetOccupantFilterOption(pThis, occupantFilterType, SelectionShape::Line);
+					}
+					else if (activeModifiers == (ModifierKeyFlagControl | ModifierKeyFlagShift))
+					{
+						handled = true;
+						SetOccupantFilterOption(pThis, occupantFilterType, SelectionShape::Polyline);
+					}
+				}
+			}
+		}
+
+		return handled;
+	}
+
+	bool __fastcall OnKeyUpHook(
+		cSC4ViewInputControlDemolish* pThis,
+		void* edxUnused,
+		int32_t vkCode,
+		int32_t modifiers)
+	{
+		const bool handled = RealOnKeyUp(pThis, vkCode, modifiers);
+
+		if (vkCode == VK_SHIFT && IsOnTop(pThis))
+		{
+			UpdateNetworkPreviewShiftState(pThis, false);
+		}
+
+		return handled;
+	}
+
+	void __fastcall Activate(cSC4ViewInputControlDemolish* pThis, void* edxUnused)
+	{
+		occupantFilterType = OccupantFilterType::None;
+		selectionShape = SelectionShape::Rectangle;
+		diagonalThickness = kDefaultDiagonalThickness; // Reset thickness to default
+		brushRadius = kDefaultBrushRadius;
+		lineWidth = kDefaultLineWidth;
+		currentViewControl = pThis;
+		diagonalRegionCache.Invalidate();
+		multiSelection.Clear();
+		selectionStartModifiers = ModifierKeyFlagNone;
+		ClearPathVertices();
+		CancelPreviewUpdate();
+		occupantClassificationMemo.Clear();
+		networkPartitionPreview.valid = false;
+
+		switch (pThis->cursorIID)
+		{
+		case cSC4ViewInputControlDemolishHooks::BulldozeCursorFlora:
 			occupantFilterType = OccupantFilterType::Flora;
 			break;
 		case cSC4ViewInputControlDemolishHooks::BulldozeCursorFloraDiagonal:
 			occupantFilterType = OccupantFilterType::Flora;
-			diagonalMode = true;
+			selectionShape = SelectionShape::Diagonal;
 			break;
 		case cSC4ViewInputControlDemolishHooks::BulldozeCursorNetwork:
 			occupantFilterType = OccupantFilterType::Network;
 			break;
 		case cSC4ViewInputControlDemolishHooks::BulldozeCursorNetworkDiagonal:
 			occupantFilterType = OccupantFilterType::Network;
-			diagonalMode = true;
+			selectionShape = SelectionShape::Diagonal;
 			break;
 		case cSC4ViewInputControlDemolishHooks::BulldozeCursorDefaultDiagonal:
-			diagonalMode = true;
+			selectionShape = SelectionShape::Diagonal;
 			break;
 		case cSC4ViewInputControlDemolishHooks::BulldozeCursorDezoneKeepNetworks:
 			occupantFilterType = OccupantFilterType::DezoneKeepNetworks;
@@ -520,6 +952,827 @@ namespace
 		}
 	}
 
+	// Identifies the selected cells and the bulldoze mode without the network mode's Shift state,
+	// the cells within the region bounds are determined by the selection shape and its settings.
+	uint64_t GetPreviewRegionKey(uint32_t flags, bool clearZonedArea)
+	{
+		uint64_t key = PreviewScheduler::kInitialKey;
+
+		key = PreviewScheduler::CombineKey(key, flags);
+		key = PreviewScheduler::CombineKey(key, clearZonedArea ? 1 : 0);
+		key = PreviewScheduler::CombineKey(key, static_cast<uint64_t>(occupantFilterType));
+		key = PreviewScheduler::CombineKey(key, static_cast<uint64_t>(selectionShape));
+		key = PreviewScheduler::CombineKey(key, multiSelection.GetVersion());
+
+		if (selectionShape != SelectionShape::Rectangle && currentViewControl && currentViewControl->pCellRegion)
+		{
+			// The shapes are drawn from the click cell to the drag end cell, the region that the
+			// shape is demolished with can have different bounds than the drag.
+			const auto& dragBounds = currentViewControl->pCellRegion->bounds;
+
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(currentViewControl->clickX));
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(currentViewControl->clickZ));
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(dragBounds.topLeftX));
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(dragBounds.topLeftY));
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(dragBounds.bottomRightX));
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(dragBounds.bottomRightY));
+		}
+
+		switch (selectionShape)
+		{
+		case SelectionShape::Diagonal:
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(diagonalThickness));
+			break;
+		case SelectionShape::CircleBrush:
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(brushRadius));
+			break;
+		case SelectionShape::Line:
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(lineWidth));
+			key = PreviewScheduler::CombineKey(key, (GetKeyState(VK_SHIFT) & 0x8000) != 0 ? 1 : 0);
+			break;
+		case SelectionShape::Polyline:
+			key = PreviewScheduler::CombineKey(key, static_cast<uint32_t>(lineWidth));
+			[[fallthrough]];
+		case SelectionShape::Lasso:
+			key = PreviewScheduler::CombineKey(key, pathCompleted ? 1 : 0);
+
+			for (const CellRegionRasterizer::CellPoint& vertex : pathVertices)
+			{
+				key = PreviewScheduler::CombineKey(
+					key,
+					(static_cast<uint64_t>(static_cast<uint32_t>(vertex.x)) << 32) | static_cast<uint32_t>(vertex.z));
+			}
+			break;
+		case SelectionShape::Rectangle:
+		case SelectionShape::Ellipse:
+		default:
+			break;
+		}
+
+		return key;
+	}
+
+	// Identifies the selected cells and the bulldoze mode.
+	uint64_t GetPreviewSelectionKey(uint32_t flags, bool clearZonedArea)
+	{
+		return PreviewScheduler::CombineKey(
+			GetPreviewRegionKey(flags, clearZonedArea),
+			keyUpModifiers & ModifierKeyFlagShift);
+	}
+
+	// Gets the occupant filter from the tuning exemplar that replaces the built-in filter of
+	// the current bulldoze mode, returns nullptr if the mode uses its built-in filter.
+	cISC4OccupantFilter* GetCustomOccupantFilter()
+	{
+		using FilterType = IOccupantFilterExpressions::FilterType;
+
+		cISC4OccupantFilter* pOccupantFilter = nullptr;
+
+		if (spOccupantFilterExpressions)
+		{
+			switch (occupantFilterType)
+			{
+			case OccupantFilterType::Flora:
+				pOccupantFilter = spOccupantFilterExpressions->GetOccupantFilter(FilterType::Flora);
+				break;
+			case OccupantFilterType::Network:
+				pOccupantFilter = spOccupantFilterExpressions->GetOccupantFilter(
+					(keyUpModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift
+					? FilterType::KeepNetworks
+					: FilterType::RemoveNetworks);
+				break;
+			case OccupantFilterType::DezoneKeepNetworks:
+				pOccupantFilter = spOccupantFilterExpressions->GetOccupantFilter(FilterType::DezoneKeepNetworks);
+				break;
+			case OccupantFilterType::None:
+			default:
+				break;
+			}
+		}
+
+		return pOccupantFilter;
+	}
+
+	// Gets the occupant categories that the current bulldoze mode demolishes.
+	uint32_t GetIncludedOccupantCategories()
+	{
+		switch (occupantFilterType)
+		{
+		case OccupantFilterType::Flora:
+			return OccupantCategoryFlagFlora;
+		case OccupantFilterType::Network:
+			if ((keyUpModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift)
+			{
+				return OccupantCategoryFlagAll & ~OccupantCategoryFlagNetwork;
+			}
+			else
+			{
+				return OccupantCategoryFlagNetwork;
+			}
+		case OccupantFilterType::None:
+		case OccupantFilterType::DezoneKeepNetworks:
+		default:
+			return OccupantCategoryFlagAll;
+		}
+	}
+
+	// Tests whether a plain rectangular selection has none of the occupants that the current
+	// bulldoze mode includes, using the category cells of the city occupant index.
+	bool IsRectangleWithoutIncludedOccupants(const SC4CellRegion<int32_t>& cellRegion, bool clearZonedArea)
+	{
+		if (!spCityOccupantIndex
+			|| selectionShape != SelectionShape::Rectangle
+			|| !multiSelection.IsEmpty()
+			|| clearZonedArea
+			|| occupantFilterType == OccupantFilterType::DezoneKeepNetworks
+			|| GetCustomOccupantFilter())
+		{
+			return false;
+		}
+
+		const OccupantSpatialIndex* pSpatialIndex = spCityOccupantIndex->GetSpatialIndex();
+
+		return pSpatialIndex && !pSpatialIndex->HasOccupants(cellRegion.bounds, GetIncludedOccupantCategories());
+	}
+
+	// Removes the cells that do not hold any occupants that the flora and network modes include,
+	// so that the game's dry run does not visit the occupants in those cells and pass them to our filter.
+	// This is only used for previews, the index may miss an occupant that the game would demolish.
+	// The remaining cells are placed in occupantCellsBounds, returns false if the region cannot be filtered.
+	bool RemoveCellsWithoutIncludedOccupants(const SC4CellRegion<int32_t>& cellRegion, bool clearZonedArea)
+	{
+		// Clearing the zones changes the cells that have no occupants.
+		// A filter expression may include occupants outside of the mode's categories.
+		if (!spCityOccupantIndex
+			|| clearZonedArea
+			|| (occupantFilterType != OccupantFilterType::Flora && occupantFilterType != OccupantFilterType::Network)
+			|| GetCustomOccupantFilter())
+		{
+			return false;
+		}
+
+		occupantCells.CopyFrom(cellRegion);
+
+		SC4Rect<int32_t> selectionBounds;
+
+		if (!occupantCells.GetSetCellBounds(selectionBounds))
+		{
+			return false;
+		}
+
+		if (!spCityOccupantIndex->RemoveCellsWithoutOccupants(occupantCells, GetIncludedOccupantCategories()))
+		{
+			return false;
+		}
+
+		SC4Rect<int32_t> occupantBounds;
+
+		if (occupantCells.GetSetCellBounds(occupantBounds))
+		{
+			// Shrink the region to the cells that are left.
+			occupantCellsBounds.Reset(
+				occupantBounds.topLeftX,
+				occupantBounds.topLeftY,
+				occupantBounds.bottomRightX,
+				occupantBounds.bottomRightY);
+			occupantCellsBounds.CopyFrom(occupantCells);
+		}
+		else
+		{
+			// None of the cells have an included occupant, one of the selected cells is kept so that
+			// the game reports the same result as it does for a selection with nothing to demolish.
+			const SC4Rect<int32_t>& regionBounds = cellRegion.bounds;
+			const uint32_t z = static_cast<uint32_t>(selectionBounds.topLeftY - regionBounds.topLeftY);
+			uint32_t x = static_cast<uint32_t>(selectionBounds.topLeftX - regionBounds.topLeftX);
+
+			while (!cellRegion.cellMap.GetValue(x, z))
+			{
+				x++;
+			}
+
+			const int32_t cellX = regionBounds.topLeftX + static_cast<int32_t>(x);
+
+			occupantCellsBounds.Reset(cellX, selectionBounds.topLeftY, cellX, selectionBounds.topLeftY);
+			occupantCellsBounds.SetValue(0, 0, true);
+		}
+
+		return true;
+	}
+
+	// Identifies the network mode's selection without the Shift state that picks the partition.
+	uint64_t GetNetworkPartitionSelectionKey(const SC4CellRegion<int32_t>& cellRegion, uint32_t flags, bool clearZonedArea)
+	{
+		const auto& bounds = cellRegion.bounds;
+
+		uint64_t selectionKey = GetPreviewRegionKey(flags, clearZonedArea);
+		selectionKey = PreviewScheduler::CombineKey(selectionKey, static_cast<uint32_t>(bounds.topLeftX));
+		selectionKey = PreviewScheduler::CombineKey(selectionKey, static_cast<uint32_t>(bounds.topLeftY));
+		selectionKey = PreviewScheduler::CombineKey(selectionKey, static_cast<uint32_t>(bounds.bottomRightX));
+		selectionKey = PreviewScheduler::CombineKey(selectionKey, static_cast<uint32_t>(bounds.bottomRightY));
+
+		return selectionKey;
+	}
+
+	size_t GetNetworkPartition()
+	{
+		return (keyUpModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift ? 1 : 0;
+	}
+
+	// The preview caches only hold the result and the cost of the game's dry run, the game fills
+	// the demolished occupant set while it runs and the set's contents are not available to us.
+	// A cached result is only replayed for a caller that did not pass a set, so there is never
+	// a set that is left unfilled.
+	bool CanReplayCachedPreview(intptr_t demolishedOccupantSet)
+	{
+		return demolishedOccupantSet == 0;
+	}
+
+	// Gets the result of an earlier dry run of the network mode's active partition over the same
+	// selection, so that pressing and releasing Shift does not repeat the dry runs.
+	// Only the result and the cost are cached, see CanReplayCachedPreview.
+	// Returns false if the partition must be dry run.
+	bool TryGetNetworkPartitionPreview(
+		uint64_t selectionKey,
+		intptr_t demolishedOccupantSet,
+		bool& result,
+		int64_t& totalCost)
+	{
+		const size_t partition = GetNetworkPartition();
+
+		if (!CanReplayCachedPreview(demolishedOccupantSet)
+			|| !networkPartitionPreview.valid
+			|| networkPartitionPreview.selectionKey != selectionKey
+			|| !networkPartitionPreview.partitionKnown[partition])
+		{
+			return false;
+		}
+
+		result = networkPartitionPreview.partitionResult[partition];
+		totalCost = networkPartitionPreview.partitionCost[partition];
+		return true;
+	}
+
+	// Stores the result and the cost of the game's dry run of the network mode's active partition.
+	// Each partition is priced by its own dry run. The game has no per-occupant cost that a single
+	// pass could split between the partitions, and a lot that holds occupants of both partitions
+	// is priced by the game as a whole.
+	void SetNetworkPartitionPreview(uint64_t selectionKey, bool result, int64_t totalCost)
+	{
+		if (!networkPartitionPreview.valid || networkPartitionPreview.selectionKey != selectionKey)
+		{
+			networkPartitionPreview = NetworkPartitionPreview{};
+			networkPartitionPreview.selectionKey = selectionKey;
+			networkPartitionPreview.valid = true;
+		}
+
+		const size_t partition = GetNetworkPartition();
+
+		networkPartitionPreview.partitionKnown[partition] = true;
+		networkPartitionPreview.partitionResult[partition] = result;
+		networkPartitionPreview.partitionCost[partition] = totalCost;
+	}
+
+	// The game updates the network connectivity and the traffic data after the network pieces
+	// that a DemolishRegion call removed, so the network removal is kept in one call.
+	// This is the network mode's removal partition, with either the built-in filter or the
+	// user's RemoveNetworks expression.
+	bool IsNetworkRemoval()
+	{
+		return occupantFilterType == OccupantFilterType::Network && GetNetworkPartition() == 0;
+	}
+
+	// Demolishes the occupants of the cells that the filter includes, the game's demolition loop
+	// passes them through the demolition driver so that the filter tests each occupant once.
+	// When the cells hold more occupants than the effect limit, the effect aggregator splits them
+	// between a call with the game's effect arguments and a call without them, so each cell is
+	// only visited once. The driver stops selecting occupants in the call with the effect arguments
+	// once the limit is reached, if the index missed some of them the call without the effect
+	// arguments visits every cell.
+	// effectCount is set to the number of occupants that kept their demolition effect.
+	bool DemolishFilteredCells(
+		cISC4Demolition* pDemolition,
+		const BitsetCellRegion& cells,
+		uint32_t privilegeType,
+		uint32_t flags,
+		cISC4OccupantFilter* pOccupantFilter,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ,
+		uint32_t includedCategories,
+		uint32_t maxEffects,
+		size_t& effectCount)
+	{
+		const auto startTime = std::chrono::steady_clock::now();
+		const OccupantSpatialIndex* pSpatialIndex = spCityOccupantIndex ? spCityOccupantIndex->GetSpatialIndex() : nullptr;
+		cISC4OccupantFilter* pDriverFilter = demolitionDriver.Begin(pOccupantFilter);
+
+		bool result = false;
+		int64_t effectCost = 0;
+		int64_t quietCost = 0;
+		const BitsetCellRegion* pQuietCells = &cells;
+
+		effectCount = 0;
+
+		if (pDemolishEffectOccupant && maxEffects > 0)
+		{
+			// The occupant counts of the index only place the effects, the game's loop decides
+			// which occupants are demolished.
+			const bool aggregateEffects = pSpatialIndex
+				&& demolitionEffectAggregator.Aggregate(*pSpatialIndex, cells, includedCategories, maxEffects);
+
+			if (!aggregateEffects || demolitionEffectAggregator.GetEffectCount() > 0)
+			{
+				demolitionDriver.SetSelectionLimit(maxEffects);
+
+				result = pDemolition->DemolishRegion(
+					true,
+					aggregateEffects
+						? demolitionEffectAggregator.GetEffectCells().CopyTo(effectCellRegion)
+						: cells.CopyTo(effectCellRegion),
+					privilegeType,
+					flags,
+					false,
+					pDriverFilter,
+					&effectCost,
+					demolishedOccupantSet,
+					pDemolishEffectOccupant,
+					demolishEffectX,
+					demolishEffectZ);
+
+				demolitionDriver.SetSelectionLimit(OccupantDemolitionDriver::kNoSelectionLimit);
+				effectCount = demolitionDriver.GetSelectedCount();
+			}
+
+			if (demolitionDriver.IsSelectionLimitReached())
+			{
+				pQuietCells = &cells;
+			}
+			else
+			{
+				pQuietCells = aggregateEffects ? &demolitionEffectAggregator.GetQuietCells() : nullptr;
+			}
+		}
+
+		if (pQuietCells && pQuietCells->PopCount() > 0)
+		{
+			result |= pDemolition->DemolishRegion(
+				true,
+				pQuietCells->CopyTo(quietCellRegion),
+				privilegeType,
+				flags,
+				false,
+				pDriverFilter,
+				&quietCost,
+				demolishedOccupantSet,
+				nullptr,
+				-1,
+				-1);
+		}
+
+		if (totalCost)
+		{
+			*totalCost = effectCost + quietCost;
+		}
+
+		Logger& logger = Logger::GetInstance();
+
+		if (logger.IsEnabled(LogLevel::Debug))
+		{
+			const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+				std::chrono::steady_clock::now() - startTime);
+
+			logger.WriteLineFormatted(
+				LogLevel::Debug,
+				"Demolition driver: tested %zu occupants, selected %zu in %llu cells, %zu kept their effect, %lld us.",
+				demolitionDriver.GetTestedCount(),
+				demolitionDriver.GetSelectedCount(),
+				static_cast<unsigned long long>(cells.PopCount()),
+				effectCount,
+				static_cast<long long>(elapsed.count()));
+		}
+
+		return result;
+	}
+
+	// Gets the occupant categories that the demolition includes, a filter expression may
+	// include occupants of any category.
+	uint32_t GetDemolitionOccupantCategories()
+	{
+		return GetCustomOccupantFilter() ? OccupantCategoryFlagAll : GetIncludedOccupantCategories();
+	}
+
+	// Gets the occupant filter of the active bulldoze mode, the dezone mode also sets clearZonedArea.
+	cISC4OccupantFilter* GetDemolitionOccupantFilter(bool& clearZonedArea)
+	{
+		cISC4OccupantFilter* pOccupantFilter = nullptr;
+
+		switch (occupantFilterType)
+		{
+		case OccupantFilterType::Flora:
+			pOccupantFilter = floraOccupantFilter;
+			break;
+		case OccupantFilterType::Network:
+			// The network bulldoze mode will change its behavior depending on if the
+			// user was holding down the shift key when they released the left mouse button.
+			if ((keyUpModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift)
+			{
+				// Keep only network occupants.
+				pOccupantFilter = keepNetworksOccupantFilter;
+			}
+			else
+			{
+				// Remove only network occupants.
+				pOccupantFilter = removeNetworksOccupantFilter;
+			}
+			break;
+		case OccupantFilterType::DezoneKeepNetworks:
+			dezoneKeepNetworksOccupantFilter->ClearLotZoneTypes();
+			pOccupantFilter = dezoneKeepNetworksOccupantFilter;
+			clearZonedArea = true;
+			break;
+		case OccupantFilterType::None:
+		default:
+			break;
+		}
+
+		cISC4OccupantFilter* pCustomOccupantFilter = GetCustomOccupantFilter();
+
+		if (pCustomOccupantFilter)
+		{
+			pOccupantFilter = pCustomOccupantFilter;
+		}
+
+		return pOccupantFilter;
+	}
+
+	void FinishChunkedDemolition()
+	{
+		if (chunkedDemolitionTimerID != 0)
+		{
+			KillTimer(nullptr, chunkedDemolitionTimerID);
+			chunkedDemolitionTimerID = 0;
+		}
+
+		Logger& logger = Logger::GetInstance();
+
+		if (logger.IsEnabled(LogLevel::Debug))
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Debug,
+				"Chunked demolition %s: demolished %llu of %llu cells, removed %zu occupants, cost %lld.",
+				chunkedDemolition.GetCompletedCellCount() < chunkedDemolition.GetTotalCellCount() ? "canceled" : "finished",
+				static_cast<unsigned long long>(chunkedDemolition.GetCompletedCellCount()),
+				static_cast<unsigned long long>(chunkedDemolition.GetTotalCellCount()),
+				chunkedDemolitionState.removedOccupantCount,
+				static_cast<long long>(chunkedDemolition.GetTotalCost()));
+		}
+
+		chunkedDemolitionProgress.Finish();
+
+		chunkedDemolitionState.demolition = nullptr;
+		chunkedDemolitionState.occupantFilter = nullptr;
+		chunkedDemolitionState.demolishEffectOccupant = nullptr;
+	}
+
+	// Demolishes the next chunk of the active chunked demolition, cost is set to the chunk's cost.
+	// Returns false if there are no chunks left.
+	bool DemolishNextChunk(intptr_t demolishedOccupantSet, bool& result, int64_t& cost)
+	{
+		const uint64_t remainingCells = chunkedDemolition.GetTotalCellCount() - chunkedDemolition.GetCompletedCellCount();
+		const BitsetCellRegion* pChunk = chunkedDemolition.GetNextChunk();
+
+		if (!pChunk)
+		{
+			return false;
+		}
+
+		ChunkedDemolitionState& state = chunkedDemolitionState;
+		cISC4Occupant* pDemolishEffectOccupant = state.demolishEffectOccupant;
+
+		// The chunk gets a share of the operation's effects in proportion to its cells, the driver
+		// never selects more occupants for the effect arguments than the effects that are left.
+		const uint64_t chunkCells = pChunk->PopCount();
+		const uint32_t chunkEffects = remainingCells > 0
+			? static_cast<uint32_t>(std::min<uint64_t>(
+				state.remainingEffects,
+				(static_cast<uint64_t>(state.remainingEffects) * chunkCells + remainingCells - 1) / remainingCells))
+			: state.remainingEffects;
+		cISC4OccupantFilter* pOccupantFilter = state.occupantFilter;
+
+		// Lots may have been rebuilt by the simulation between the chunks.
+		dezoneKeepNetworksOccupantFilter->ClearLotZoneTypes();
+		cost = 0;
+
+		if (pOccupantFilter && !state.clearZonedArea)
+		{
+			size_t effectCount = 0;
+
+			result = DemolishFilteredCells(
+				state.demolition,
+				*pChunk,
+				state.privilegeType,
+				state.flags,
+				pOccupantFilter,
+				&cost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				state.demolishEffectX,
+				state.demolishEffectZ,
+				state.includedCategories,
+				chunkEffects,
+				effectCount);
+
+			state.remainingEffects -= static_cast<uint32_t>(std::min<size_t>(state.remainingEffects, effectCount));
+		}
+		else
+		{
+			// The game's demolition loop spawns an effect for each occupant, so only the first
+			// chunk keeps the effect arguments.
+			const bool firstChunk = remainingCells == chunkedDemolition.GetTotalCellCount();
+
+			result = state.demolition->DemolishRegion(
+				true,
+				pChunk->CopyTo(selectedCellRegion),
+				state.privilegeType,
+				state.flags,
+				state.clearZonedArea,
+				pOccupantFilter,
+				&cost,
+				demolishedOccupantSet,
+				firstChunk ? pDemolishEffectOccupant : nullptr,
+				firstChunk ? state.demolishEffectX : -1,
+				firstChunk ? state.demolishEffectZ : -1);
+		}
+
+		chunkedDemolition.CompleteChunk(result, cost);
+		chunkedDemolitionProgress.SetProgress(chunkedDemolition.GetCompletedCellCount(), chunkedDemolition.GetTotalCellCount());
+
+		Logger& logger = Logger::GetInstance();
+
+		if (logger.IsEnabled(LogLevel::Debug))
+		{
+			logger.WriteLineFormatted(
+				LogLevel::Debug,
+				"Chunked demolition: %llu of %llu cells.",
+				static_cast<unsigned long long>(chunkedDemolition.GetCompletedCellCount()),
+				static_cast<unsigned long long>(chunkedDemolition.GetTotalCellCount()));
+		}
+
+		return true;
+	}
+
+	void CALLBACK ChunkedDemolitionTimerProc(HWND hwnd, UINT message, UINT_PTR timerID, DWORD time)
+	{
+		bool result = false;
+		int64_t cost = 0;
+
+		if (!DemolishNextChunk(0, result, cost))
+		{
+			FinishChunkedDemolition();
+		}
+	}
+
+	// Demolishes the remaining chunks of the active chunked demolition immediately.
+	void CompleteChunkedDemolition()
+	{
+		// The timer runs until the demolition has finished or its cancellation was handled.
+		if (chunkedDemolitionTimerID != 0)
+		{
+			bool result = false;
+			int64_t cost = 0;
+
+			while (DemolishNextChunk(0, result, cost))
+			{
+			}
+
+			FinishChunkedDemolition();
+		}
+	}
+
+	bool DemolishFilteredRegion(
+		cISC4Demolition* pDemolition,
+		bool demolish,
+		const SC4CellRegion<int32_t>& cellRegion,
+		uint32_t privilegeType,
+		uint32_t flags,
+		bool clearZonedArea,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ)
+	{
+		const bool networkPreview = !demolish && occupantFilterType == OccupantFilterType::Network;
+		uint64_t networkSelectionKey = 0;
+
+		if (networkPreview)
+		{
+			networkSelectionKey = GetNetworkPartitionSelectionKey(cellRegion, flags, clearZonedArea);
+
+			bool partitionResult = false;
+			int64_t partitionCost = 0;
+
+			if (TryGetNetworkPartitionPreview(networkSelectionKey, demolishedOccupantSet, partitionResult, partitionCost))
+			{
+				if (totalCost)
+				{
+					*totalCost = partitionCost;
+				}
+
+				return partitionResult;
+			}
+		}
+
+		cISC4OccupantFilter* pOccupantFilter = GetDemolitionOccupantFilter(clearZonedArea);
+
+		// The filtered modes demolish every selected cell, the game's demolition loop decides which
+		// occupants are removed. Clearing the zones is left to the game's single call.
+		if (demolish && pOccupantFilter && !clearZonedArea)
+		{
+			occupantCellsBounds.CopyFrom(cellRegion);
+
+			size_t effectCount = 0;
+
+			return DemolishFilteredCells(
+				pDemolition,
+				occupantCellsBounds,
+				privilegeType,
+				flags,
+				pOccupantFilter,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ,
+				GetDemolitionOccupantCategories(),
+				kMaxDemolitionEffects,
+				effectCount);
+		}
+
+		bool result = false;
+
+		if (!demolish && RemoveCellsWithoutIncludedOccupants(cellRegion, clearZonedArea))
+		{
+			result = pDemolition->DemolishRegion(
+				demolish,
+				occupantCellsBounds.CopyTo(occupantCellRegion),
+				privilegeType,
+				flags,
+				clearZonedArea,
+				pOccupantFilter,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ);
+		}
+		else
+		{
+			result = pDemolition->DemolishRegion(
+				demolish,
+				cellRegion,
+				privilegeType,
+				flags,
+				clearZonedArea,
+				pOccupantFilter,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ);
+		}
+
+		if (networkPreview && totalCost)
+		{
+			SetNetworkPartitionPreview(networkSelectionKey, result, *totalCost);
+		}
+
+		return result;
+	}
+
+	// Splits a large selection into bands of rows that are demolished one per frame, the first
+	// band is demolished immediately with the game's arguments. Each band is charged by its own
+	// demolition call, so the caller gets the first band's cost and result, and the finished or
+	// canceled demolition logs the summed cost of the bands that were demolished.
+	// The progress is shown on the game's taskbar button.
+	// Returns false if the selection is small enough to be demolished in one call, or if it is
+	// a network removal.
+	bool TryStartChunkedDemolition(
+		cISC4Demolition* pDemolition,
+		const SC4CellRegion<int32_t>& cellRegion,
+		uint32_t privilegeType,
+		uint32_t flags,
+		bool clearZonedArea,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ,
+		bool& result)
+	{
+		// A new demolition may overlap the cells of the previous one.
+		CompleteChunkedDemolition();
+
+		bool chunkClearZonedArea = clearZonedArea;
+		cISC4OccupantFilter* pOccupantFilter = GetDemolitionOccupantFilter(chunkClearZonedArea);
+
+		if (IsNetworkRemoval())
+		{
+			return false;
+		}
+
+		chunkedDemolition.Start(cellRegion, kChunkedDemolitionCellsPerChunk);
+
+		if (chunkedDemolition.GetTotalCellCount() <= kChunkedDemolitionMinCells)
+		{
+			chunkedDemolition.Cancel();
+			return false;
+		}
+
+		ChunkedDemolitionState& state = chunkedDemolitionState;
+		state.demolition = pDemolition;
+		state.privilegeType = privilegeType;
+		state.flags = flags;
+		state.clearZonedArea = chunkClearZonedArea;
+		state.occupantFilter = pOccupantFilter;
+		state.demolishEffectOccupant = pDemolishEffectOccupant;
+		state.demolishEffectX = demolishEffectX;
+		state.demolishEffectZ = demolishEffectZ;
+		state.includedCategories = GetDemolitionOccupantCategories();
+		state.remainingEffects = kMaxDemolitionEffects;
+		state.removedOccupantCount = 0;
+
+		chunkedDemolitionProgress.Start(GetActiveWindow());
+
+		int64_t cost = 0;
+
+		DemolishNextChunk(demolishedOccupantSet, result, cost);
+
+		if (totalCost)
+		{
+			*totalCost = cost;
+		}
+
+		if (chunkedDemolition.IsActive())
+		{
+			chunkedDemolitionTimerID = SetTimer(nullptr, 0, kChunkedDemolitionIntervalMs, &ChunkedDemolitionTimerProc);
+		}
+		else
+		{
+			FinishChunkedDemolition();
+		}
+
+		return true;
+	}
+
+	bool DemolishSelection(
+		cISC4Demolition* pDemolition,
+		bool demolish,
+		const SC4CellRegion<int32_t>& cellRegion,
+		uint32_t privilegeType,
+		uint32_t flags,
+		bool clearZonedArea,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ)
+	{
+		bool result = false;
+
+		if (demolish
+			&& TryStartChunkedDemolition(
+				pDemolition,
+				cellRegion,
+				privilegeType,
+				flags,
+				clearZonedArea,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ,
+				result))
+		{
+			return result;
+		}
+
+		return DemolishFilteredRegion(
+			pDemolition,
+			demolish,
+			cellRegion,
+			privilegeType,
+			flags,
+			clearZonedArea,
+			totalCost,
+			demolishedOccupantSet,
+			pDemolishEffectOccupant,
+			demolishEffectX,
+			demolishEffectZ);
+	}
+
 	bool DemolishRegion(
 		cISC4Demolition* pDemolition,
 		bool demolish,
@@ -533,43 +1786,224 @@ namespace
 		long demolishEffectX,
 		long demolishEffectZ)
 	{
-		cRZAutoRefCount<cISC4OccupantFilter> occupantFilter;
+		if (demolish)
+		{
+			CancelPreviewUpdate();
+			networkPartitionPreview.valid = false;
+		}
+		else if (CanReplayCachedPreview(demolishedOccupantSet))
+		{
+			bool previewResult = false;
+			int64_t previewCost = 0;
+
+			if (previewScheduler.TryGetResult(
+				cellRegion.bounds,
+				GetPreviewSelectionKey(flags, clearZonedArea),
+				GetTickCount64(),
+				previewResult,
+				previewCost))
+			{
+				if (previewScheduler.HasPendingUpdate())
+				{
+					SchedulePreviewUpdate();
+				}
 
-		switch (occupantFilterType)
+				if (totalCost)
+				{
+					*totalCost = previewCost;
+				}
+
+				return previewResult;
+			}
+		}
+
+		bool result = false;
+
+		if (!demolish && IsRectangleWithoutIncludedOccupants(cellRegion, clearZonedArea))
 		{
-		case OccupantFilterType::Flora:
-			occupantFilter = new FloraOccupantFilter();
-			break;
-		case OccupantFilterType::Network:
-			// The network bulldoze mode will change its behavior depending on if the
-			// user was holding down the shift key when they released the left mouse button.
-			if ((keyUpModifiers & ModifierKeyFlagShift) == ModifierKeyFlagShift)
+			// The game still decides whether a selection with nothing to demolish is valid,
+			// it gives the same result for one of the selection's cells.
+			const auto& bounds = cellRegion.bounds;
+
+			if (!emptySelectionCellRegion)
 			{
-				// Keep only network occupants.
-				occupantFilter = new KeepNetworksOccupantFilter(NetworkTypeFlags::AllTransportationNetworks);
+				emptySelectionCellRegion.emplace(0, 0, 0, 0, true);
 			}
-			else
+
+			// The single cell map is moved to the selection's first cell.
+			emptySelectionCellRegion->bounds = SC4Rect<int32_t>{ bounds.topLeftX, bounds.topLeftY, bounds.topLeftX, bounds.topLeftY };
+
+			result = DemolishSelection(
+				pDemolition,
+				demolish,
+				*emptySelectionCellRegion,
+				privilegeType,
+				flags,
+				clearZonedArea,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ);
+		}
+		else if (multiSelection.IsEmpty())
+		{
+			result = DemolishSelection(
+				pDemolition,
+				demolish,
+				cellRegion,
+				privilegeType,
+				flags,
+				clearZonedArea,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ);
+		}
+		else
+		{
+			// Include the areas from the previous drags, so that the preview shows the whole
+			// selection and it is demolished in one call.
+			const SC4CellRegion<int32_t>& combinedRegion = multiSelection.Combine(cellRegion);
+
+			if (demolish)
 			{
-				// Remove only network occupants.
-				occupantFilter = new RemoveNetworksOccupantFilter(NetworkTypeFlags::AllTransportationNetworks);
+				multiSelection.Clear();
+			}
+
+			result = DemolishSelection(
+				pDemolition,
+				demolish,
+				combinedRegion,
+				privilegeType,
+				flags,
+				clearZonedArea,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ);
+		}
+
+		if (!demolish)
+		{
+			previewScheduler.SetResult(result, totalCost ? *totalCost : 0);
+		}
+
+		return result;
+	}
+
+	bool DemolishDiagonalRegion(
+		cISC4Demolition* pDemolition,
+		bool demolish,
+		const SC4CellRegion<int32_t>& cellRegion,
+		uint32_t flags,
+		bool clearZonedArea,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ)
+	{
+		const auto& bounds = cellRegion.bounds;
+
+		if (currentViewControl && currentViewControl->pCellRegion)
+		{
+			SC4CellRegion<int32_t>* pViewRegion = currentViewControl->pCellRegion;
+			const auto& viewBounds = pViewRegion->bounds;
+
+			// Draw the diagonal directly into the view control's cellMap when it covers the
+			// same area, this avoids allocating and copying a separate region.
+			if (viewBounds.topLeftX == bounds.topLeftX &&
+				viewBounds.topLeftY == bounds.topLeftY &&
+				viewBounds.bottomRightX == bounds.bottomRightX &&
+				viewBounds.bottomRightY == bounds.bottomRightY &&
+				diagonalRegionCache.Apply(
+					*pViewRegion,
+					diagonalThickness,
+					currentViewControl->clickX,
+					currentViewControl->clickZ))
+			{
+				return DemolishRegion(
+					pDemolition,
+					demolish,
+					*pViewRegion,
+					1, // privilegeType
+					flags,
+					clearZonedArea,
+					totalCost,
+					demolishedOccupantSet,
+					pDemolishEffectOccupant,
+					demolishEffectX,
+					demolishEffectZ);
 			}
-			break;
-		case OccupantFilterType::DezoneKeepNetworks:
-			occupantFilter = new DezoneKeepNetworksOccupantFilter();
-			clearZonedArea = true;
-			break;
-		case OccupantFilterType::None:
-		default:
-			break;
 		}
 
-		return pDemolition->DemolishRegion(
+		// Create diagonal region using reliable click coordinates
+		SC4CellRegion<int32_t> diagonalRegion = CellRegionRasterizer::CreateDiagonalRegion(
+			bounds.topLeftX,
+			bounds.topLeftY,
+			bounds.bottomRightX,
+			bounds.bottomRightY,
+			diagonalThickness,
+			currentViewControl ? currentViewControl->clickX : -1,
+			currentViewControl ? currentViewControl->clickZ : -1);
+
+		return DemolishRegion(
+			pDemolition,
 			demolish,
-			cellRegion,
-			privilegeType,
+			diagonalRegion,
+			1, // privilegeType
+			flags,
+			clearZonedArea,
+			totalCost,
+			demolishedOccupantSet,
+			pDemolishEffectOccupant,
+			demolishEffectX,
+			demolishEffectZ);
+	}
+
+	bool DemolishShapeRegion(
+		cISC4Demolition* pDemolition,
+		bool demolish,
+		uint32_t flags,
+		bool clearZonedArea,
+		int64_t* totalCost,
+		intptr_t demolishedOccupantSet,
+		cISC4Occupant* pDemolishEffectOccupant,
+		long demolishEffectX,
+		long demolishEffectZ)
+	{
+		RasterizeShape(currentViewControl);
+
+		SC4CellRegion<int32_t>* pViewRegion = currentViewControl->pCellRegion;
+
+		// Draw the shape into the view control's cellMap when it covers the same area, so that
+		// the selection grid matches the shape.
+		if (shapeRegion.CopyTo(*pViewRegion))
+		{
+			return DemolishRegion(
+				pDemolition,
+				demolish,
+				*pViewRegion,
+				1, // privilegeType
+				flags,
+				clearZonedArea,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ);
+		}
+
+		return DemolishRegion(
+			pDemolition,
+			demolish,
+			shapeRegion.CopyTo(shapeCellRegion),
+			1, // privilegeType
 			flags,
 			clearZonedArea,
-			occupantFilter,
 			totalCost,
 			demolishedOccupantSet,
 			pDemolishEffectOccupant,
@@ -591,6 +2025,12 @@ namespace
 		long demolishEffectX,
 		long demolishEffectZ)
 	{
+		// The preview follows the Shift key, so that the network mode shows the occupants that
+		// releasing the mouse button would demolish.
+		keyUpModifiers = static_cast<ModifierKeyFlags>(
+			(keyUpModifiers & ~ModifierKeyFlagShift)
+			| ((GetKeyState(VK_SHIFT) & 0x8000) != 0 ? ModifierKeyFlagShift : ModifierKeyFlagNone));
+
 		// Set preview colors based on bulldoze mode
 		if (currentViewControl && spBulldozeHighlightColors)
 		{
@@ -609,56 +2049,11 @@ namespace
 			currentViewControl->demolishOK = spBulldozeHighlightColors->GetDemolishOKColor(type);
 		}
 
-		// Apply diagonal modification if enabled and we have valid view control
-		if (diagonalMode && currentViewControl && currentViewControl->pCellRegion)
+		if (IsRasterizedShape(selectionShape) && currentViewControl && currentViewControl->pCellRegion)
 		{
-			cSC4ViewInputControlDemolish* pViewControl = currentViewControl;
-			const auto& bounds = cellRegion.bounds;
-
-			// Create diagonal region using reliable click coordinates
-			SC4CellRegion<int32_t> diagonalRegion = CreateDiagonalRegion(
-				bounds.topLeftX,
-				bounds.topLeftY,
-				bounds.bottomRightX,
-				bounds.bottomRightY,
-				pViewControl->clickX,
-				pViewControl->clickZ
-			);
-
-			// Update view control's cellMap contents without changing structure
-			auto& existingCellMap = pViewControl->pCellRegion->cellMap;
-			const auto& diagonalCellMap = diagonalRegion.cellMap;
-
-			// Calculate dimensions from bounds
-			const auto& existingBounds = pViewControl->pCellRegion->bounds;
-			const auto& diagonalBounds = diagonalRegion.bounds;
-
-			uint32_t width = static_cast<uint32_t>(bounds.bottomRightX - bounds.topLeftX + 1);
-			uint32_t height = static_cast<uint32_t>(bounds.bottomRightY - bounds.topLeftY + 1);
-
-			// Verify bounds match and update cellMap safely
-			if (existingBounds.topLeftX == diagonalBounds.topLeftX &&
-				existingBounds.topLeftY == diagonalBounds.topLeftY &&
-				existingBounds.bottomRightX == diagonalBounds.bottomRightX &&
-				existingBounds.bottomRightY == diagonalBounds.bottomRightY)
-			{
-				// Copy diagonal pattern into existing cellMap
-				for (uint32_t x = 0; x < width; x++)
-				{
-					for (uint32_t z = 0; z < height; z++)
-					{
-						bool diagonalValue = diagonalCellMap.GetValue(x, z);
-						existingCellMap.SetValue(x, z, diagonalValue);
-					}
-				}
-			}
-
-			// Call demolish with diagonal region for preview calculation
-			bool result = DemolishRegion(
+			return DemolishShapeRegion(
 				pDemolition,
 				false, // demolish
-				diagonalRegion,
-				1, // privilegeType
 				flags,
 				clearZonedArea,
 				totalCost,
@@ -666,8 +2061,22 @@ namespace
 				pDemolishEffectOccupant,
 				demolishEffectX,
 				demolishEffectZ);
+		}
 
-			return result;
+		// Apply diagonal modification if enabled and we have valid view control
+		if (selectionShape == SelectionShape::Diagonal && currentViewControl && currentViewControl->pCellRegion)
+		{
+			return DemolishDiagonalRegion(
+				pDemolition,
+				false, // demolish
+				cellRegion,
+				flags,
+				clearZonedArea,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ);
 		}
 
 		// Normal rectangular bulldoze preview
@@ -699,27 +2108,27 @@ namespace
 		long demolishEffectX,
 		long demolishEffectZ)
 	{
+		if (IsRasterizedShape(selectionShape) && currentViewControl && currentViewControl->pCellRegion)
+		{
+			return DemolishShapeRegion(
+				pDemolition,
+				true, // demolish
+				flags,
+				clearZonedArea,
+				totalCost,
+				demolishedOccupantSet,
+				pDemolishEffectOccupant,
+				demolishEffectX,
+				demolishEffectZ);
+		}
 
 		// Apply diagonal modification if enabled
-		if (diagonalMode)
+		if (selectionShape == SelectionShape::Diagonal)
 		{
-			const auto& bounds = cellRegion.bounds;
-
-			// Create diagonal region using reliable click coordinates
-			SC4CellRegion<int32_t> diagonalRegion = CreateDiagonalRegion(
-				bounds.topLeftX,
-				bounds.topLeftY,
-				bounds.bottomRightX,
-				bounds.bottomRightY,
-				currentViewControl ? currentViewControl->clickX : -1,
-				currentViewControl ? currentViewControl->clickZ : -1
-			);
-
-			return DemolishRegion(
+			return DemolishDiagonalRegion(
 				pDemolition,
 				true, // demolish
-				diagonalRegion,
-				1, // privilegeType
+				cellRegion,
 				flags,
 				clearZonedArea,
 				totalCost,
@@ -792,6 +2201,35 @@ cRZAutoRefCount<cISC4ViewInputControl> cSC4ViewInputControlDemolishHooks::Create
 	return instance;
 }
 
+void cSC4ViewInputControlDemolishHooks::OccupantInserted()
+{
+	CityOccupantsChanged();
+}
+
+void cSC4ViewInputControlDemolishHooks::OccupantRemoved(cISC4Occupant* pOccupant)
+{
+	demolitionDriver.OccupantRemoved(pOccupant);
+
+	// The removed occupant's pointer may be reused by a new occupant, and the removal
+	// can change the lot of the other occupants on its lot.
+	occupantClassificationMemo.Remove(pOccupant);
+	CityOccupantsChanged();
+
+	if (chunkedDemolition.IsActive())
+	{
+		chunkedDemolitionState.removedOccupantCount++;
+	}
+}
+
+void cSC4ViewInputControlDemolishHooks::CityShutdown()
+{
+	if (chunkedDemolitionTimerID != 0)
+	{
+		chunkedDemolition.Cancel();
+		FinishChunkedDemolition();
+	}
+}
+
 bool cSC4ViewInputControlDemolishHooks::Install()
 {
 	bool installed = false;
@@ -801,9 +2239,16 @@ bool cSC4ViewInputControlDemolishHooks::Install()
 
 	if (gameVersion == 641)
 	{
+		CreateOccupantFilters();
+
 		try
 		{
+			RealOnKeyUp = *reinterpret_cast<PFN_cSC4ViewInputControlDemolish_OnKeyUp*>(0xa901dc);
+			RealOnMouseDownL = *reinterpret_cast<PFN_cSC4ViewInputControlDemolish_OnMouseDownL*>(0xa901e0);
+
 			Patcher::InstallJumpTableHook(0xa901d8, reinterpret_cast<uintptr_t>(&OnKeyDownHook));
+			Patcher::InstallJumpTableHook(0xa901dc, reinterpret_cast<uintptr_t>(&OnKeyUpHook));
+			Patcher::InstallJumpTableHook(0xa901e0, reinterpret_cast<uintptr_t>(&OnMouseDownHook));
 			Patcher::InstallJumpTableHook(0xa901e8, reinterpret_cast<uintptr_t>(&OnMouseUpHook));
 			Patcher::InstallJumpTableHook(0xa901f4, reinterpret_cast<uintptr_t>(&OnMouseWheelHook));
 			Patcher::InstallJumpTableHook(0xa901fc, reinterpret_cast<uintptr_t>(&Activate));
@@ -24,6 +24,8 @@
 #include "cRZAutoRefCount.h"
 #include <cstdint>
 
+class cISC4Occupant;
+
 namespace cSC4ViewInputControlDemolishHooks
 {
 	enum BulldozeCursor : uint32_t
@@ -39,5 +41,15 @@ namespace cSC4ViewInputControlDemolishHooks
 
 	cRZAutoRefCount<cISC4ViewInputControl> CreateViewInputControl(BulldozeCursor cursor);
 
+	// Marks the cached preview results of the active bulldoze tool as stale.
+	void OccupantInserted();
+
+	// Clears the cached occupant classifications and preview results of the active bulldoze tool,
+	// and forgets the demolition driver's answer for the removed occupant.
+	void OccupantRemoved(cISC4Occupant* pOccupant);
+
+	// Cancels the bulldoze operations that are still running.
+	void CityShutdown();
+
 	bool Install();
 }
\ No newline at end of file